@@ -0,0 +1,394 @@
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SCL Micro-Benchmarks                                                       */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Every operation is timed for T in {i8, i16, i32, i64, f32, f64} and N in   */
+/* {2, 4, 8, 16, 32, 64}, in up to two modes:                                 */
+/*                                                                            */
+/*     throughput - independent operations over a buffer that fits in L1.     */
+/*                  items_per_second counts lanes, not vectors.               */
+/*     latency    - a dependent chain where each result feeds the next op.    */
+/*                                                                            */
+/* Both modes report per_op, the time taken by a single vector operation.     */
+/* Names read <op>/<type>/<N>/<mode>, so --benchmark_filter='add/f32/.*'      */
+/* selects one operation and element type.                                    */
+/*                                                                            */
+/*============================================================================*/
+
+/* Standard Includes */
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Third-Party Includes */
+#include <benchmark/benchmark.h>
+
+/* Sforzinda Includes */
+#include "scl.hpp"
+
+namespace {
+
+using namespace sf::scl;
+
+/* Vectors per throughput iteration; large enough to hide loop overhead */
+/* and small enough that even simd<double, 64> operands stay in L1.     */
+constexpr std::size_t buffer_vectors = 16;
+
+/* Dependent operations per latency iteration. */
+constexpr std::size_t chain_length = 16;
+
+template<typename T> constexpr const char* type_name = "";
+template<> constexpr const char* type_name<std::int8_t>  = "i8";
+template<> constexpr const char* type_name<std::int16_t> = "i16";
+template<> constexpr const char* type_name<std::int32_t> = "i32";
+template<> constexpr const char* type_name<std::int64_t> = "i64";
+template<> constexpr const char* type_name<float>        = "f32";
+template<> constexpr const char* type_name<double>       = "f64";
+
+/*--------------------*/
+/* Index Permutations */
+/*--------------------*/
+
+template<typename T, std::size_t N, std::size_t... I>
+simd<T, N> reverse(const simd<T, N>& v, std::index_sequence<I...>) {
+    return permute<(N - 1 - I)...>(v);
+}
+
+template<typename T, std::size_t N, std::size_t... I>
+simd<T, N> interleave(const simd<T, N>& a, const simd<T, N>& b,
+                      std::index_sequence<I...>) {
+    return shuffle<(I / 2 + (I % 2) * N)...>(a, b);
+}
+
+template<typename T, std::size_t N, std::size_t... I>
+simd<T, N> alternate(const simd<T, N>& a, const simd<T, N>& b,
+                     std::index_sequence<I...>) {
+    return blend<(I % 2 ? I + N : I)...>(a, b);
+}
+
+/*------------*/
+/* Operations */
+/*------------*/
+
+/* Each operation maps (a, b) to a vector of the same type so that it can */
+/* be chained. identity is the b that keeps a latency chain from drifting */
+/* into overflow or denormals; DoNotOptimize hides its value from the     */
+/* compiler so the chain is not folded away.                              */
+
+struct op_add {
+    static constexpr const char* name = "add";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return a + b;
+    }
+};
+
+struct op_sub {
+    static constexpr const char* name = "sub";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return a - b;
+    }
+};
+
+struct op_mul {
+    static constexpr const char* name = "mul";
+    static constexpr int identity = 1;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return a * b;
+    }
+};
+
+struct op_div {
+    static constexpr const char* name = "div";
+    static constexpr int identity = 1;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return a / b;
+    }
+};
+
+struct op_fma {
+    static constexpr const char* name = "fma";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return fma(a, b, a);
+    }
+};
+
+struct op_min {
+    static constexpr const char* name = "min";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return min(a, b);
+    }
+};
+
+struct op_compare_select {
+    static constexpr const char* name = "compare_select";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return select<T, N>(a < b, b, a);
+    }
+};
+
+struct op_equal_select {
+    static constexpr const char* name = "equal_select";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return select<T, N>(a == b, b, a);
+    }
+};
+
+struct op_permute {
+    static constexpr const char* name = "permute";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>&) {
+        return reverse(a, std::make_index_sequence<N>{});
+    }
+};
+
+struct op_shuffle {
+    static constexpr const char* name = "shuffle";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return interleave(a, b, std::make_index_sequence<N>{});
+    }
+};
+
+struct op_blend {
+    static constexpr const char* name = "blend";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>& b) {
+        return alternate(a, b, std::make_index_sequence<N>{});
+    }
+};
+
+/* Reductions are broadcast back so they can be chained. The sum is then */
+/* clamped by a, which keeps the chain bounded, so its latency mode also  */
+/* includes one min.                                                      */
+
+struct op_horizontal_sum {
+    static constexpr const char* name = "horizontal_sum";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>&) {
+        return min(simd<T, N>(a.horizontal_sum()), a);
+    }
+};
+
+struct op_horizontal_min {
+    static constexpr const char* name = "horizontal_min";
+    static constexpr int identity = 0;
+    template<typename T, std::size_t N>
+    static simd<T, N> apply(const simd<T, N>& a, const simd<T, N>&) {
+        return simd<T, N>(a.horizontal_min());
+    }
+};
+
+/*---------------------*/
+/* Benchmark Templates */
+/*---------------------*/
+
+template<typename T>
+std::vector<T, aligned_allocator<T>> make_buffer(std::size_t count, int base) {
+    std::vector<T, aligned_allocator<T>> buffer(count);
+    for (std::size_t i = 0; i < count; ++i) {
+         buffer[i] = static_cast<T>(base + static_cast<int>(i % 7) + 1);
+    }
+    return buffer;
+}
+
+template<typename Op, typename T, std::size_t N>
+void throughput(benchmark::State& state) {
+    const auto lhs = make_buffer<T>(buffer_vectors * N, 0);
+    const auto rhs = make_buffer<T>(buffer_vectors * N, 0);
+    auto       out = make_buffer<T>(buffer_vectors * N, 0);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < buffer_vectors; ++i) {
+             simd<T, N> a;
+             simd<T, N> b;
+             a.load_aligned(lhs.data() + i * N);
+             b.load_aligned(rhs.data() + i * N);
+             Op::apply(a, b).store_aligned(out.data() + i * N);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    const double ops = static_cast<double>(state.iterations() * buffer_vectors);
+    state.SetItemsProcessed(state.iterations() * buffer_vectors * N);
+    state.counters["per_op"] = benchmark::Counter(
+        ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template<typename Op, typename T, std::size_t N>
+void latency(benchmark::State& state) {
+    const auto seed = make_buffer<T>(N, 0);
+
+    simd<T, N> acc;
+    acc.load(seed.data());
+    simd<T, N> b(static_cast<T>(Op::identity));
+    benchmark::DoNotOptimize(b);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < chain_length; ++i) {
+             acc = Op::apply(acc, b);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+
+    const double ops = static_cast<double>(state.iterations() * chain_length);
+    state.counters["per_op"] = benchmark::Counter(
+        ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+/* Copies a buffer through simd registers with the given load and store. */
+template<typename T, std::size_t N, bool Aligned>
+void load_store(benchmark::State& state) {
+    const auto src = make_buffer<T>(buffer_vectors * N, 0);
+    auto       dst = make_buffer<T>(buffer_vectors * N, 0);
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < buffer_vectors; ++i) {
+             simd<T, N> v;
+             if constexpr (Aligned) {
+                 v.load_aligned(src.data() + i * N);
+                 v.store_aligned(dst.data() + i * N);
+             } else {
+                 v.load(src.data() + i * N);
+                 v.store(dst.data() + i * N);
+             }
+        }
+        benchmark::ClobberMemory();
+    }
+
+    const double ops = static_cast<double>(state.iterations() * buffer_vectors);
+    state.SetItemsProcessed(state.iterations() * buffer_vectors * N);
+    state.SetBytesProcessed(state.iterations() * buffer_vectors * N * sizeof(T));
+    state.counters["per_op"] = benchmark::Counter(
+        ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+/*--------------*/
+/* Registration */
+/*--------------*/
+
+std::string bench_name(const char* op, const char* type, std::size_t n,
+                       const char* mode) {
+    return std::string(op) + "/" + type + "/" + std::to_string(n) + "/" + mode;
+}
+
+template<typename Op, typename T, std::size_t N>
+void register_op() {
+    benchmark::RegisterBenchmark(
+        bench_name(Op::name, type_name<T>, N, "throughput").c_str(),
+        throughput<Op, T, N>);
+    benchmark::RegisterBenchmark(
+        bench_name(Op::name, type_name<T>, N, "latency").c_str(),
+        latency<Op, T, N>);
+}
+
+template<typename T, std::size_t N>
+void register_width() {
+    register_op<op_add,            T, N>();
+    register_op<op_sub,            T, N>();
+    register_op<op_mul,            T, N>();
+    register_op<op_div,            T, N>();
+    register_op<op_fma,            T, N>();
+    register_op<op_min,            T, N>();
+    register_op<op_compare_select, T, N>();
+    register_op<op_equal_select,   T, N>();
+    register_op<op_permute,        T, N>();
+    register_op<op_shuffle,        T, N>();
+    register_op<op_blend,          T, N>();
+    register_op<op_horizontal_sum, T, N>();
+    register_op<op_horizontal_min, T, N>();
+
+    benchmark::RegisterBenchmark(
+        bench_name("load_store", type_name<T>, N, "throughput").c_str(),
+        load_store<T, N, false>);
+    benchmark::RegisterBenchmark(
+        bench_name("load_store_aligned", type_name<T>, N, "throughput").c_str(),
+        load_store<T, N, true>);
+}
+
+template<typename T>
+void register_type() {
+    register_width<T, 2>();
+    register_width<T, 4>();
+    register_width<T, 8>();
+    register_width<T, 16>();
+    register_width<T, 32>();
+    register_width<T, 64>();
+}
+
+/* Recorded in the benchmark context so JSON results from different */
+/* compilers and targets can be told apart when compared.            */
+void add_context() {
+    #if defined(__clang__)
+        benchmark::AddCustomContext("scl_compiler", "clang " __clang_version__);
+    #elif defined(__GNUC__)
+        benchmark::AddCustomContext("scl_compiler", "gcc " __VERSION__);
+    #elif defined(_MSC_VER)
+        benchmark::AddCustomContext("scl_compiler",
+                                    "msvc " + std::to_string(_MSC_FULL_VER));
+    #endif
+
+    #if defined(__clang__)
+        benchmark::AddCustomContext("scl_storage", "vector_size");
+    #else
+        benchmark::AddCustomContext("scl_storage", "std::array");
+    #endif
+
+    std::string isa;
+    #if defined(SF_ISA_SSE2)
+        isa += " sse2";
+    #endif
+    #if defined(SF_ISA_AVX)
+        isa += " avx";
+    #endif
+    #if defined(SF_ISA_AVX2)
+        isa += " avx2";
+    #endif
+    #if defined(SF_ISA_AVX512F)
+        isa += " avx512f";
+    #endif
+    #if defined(SF_ISA_FMA)
+        isa += " fma";
+    #endif
+    benchmark::AddCustomContext("scl_isa", isa.empty() ? "generic" : isa.substr(1));
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+    register_type<std::int8_t>();
+    register_type<std::int16_t>();
+    register_type<std::int32_t>();
+    register_type<std::int64_t>();
+    register_type<float>();
+    register_type<double>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    add_context();
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,410 @@
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SCL Codegen Checks                                                         */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Each function below loads its operands, applies one simd operation and     */
+/* stores the result. CMake compiles this file to assembly once per target    */
+/* and FileCheck matches the output against the comments under each label:    */
+/*                                                                            */
+/*     CHECK - every target: the function contains no local branch labels,    */
+/*             so neither the operation nor its loads and stores loop over    */
+/*             lanes.                                                         */
+/*     X86   - x86-64 at the SSE2, AVX2 and AVX-512 levels, with X86-SSE2     */
+/*             for the SSE2 level only and X86-SSE41 for the levels that have */
+/*             SSE4.1.                                                        */
+/*     A64   - AArch64 with NEON.                                             */
+/*     RVV   - RISC-V with the V extension and a fixed vector length.         */
+/*                                                                            */
+/* The x86 levels are also compiled with -ffast-math, and the checks must     */
+/* hold there too; only division may become rcpps and a Newton step.          */
+/*                                                                            */
+/* The per-target line names the vector instruction the operation should     */
+/* lower to; both the SSE and VEX forms are accepted on x86. Operations that  */
+/* only move lanes (blend, permute, shuffle, split, merge) accept any vector  */
+/* instruction, as the best choice varies with the target and the compiler.   */
+/* Reductions end in scalar code by nature, and are checked for their vector  */
+/* first step and for the absence of a loop.                                  */
+/*                                                                            */
+/* The operands are simd<float, 8>, simd<int32_t, 8> and simd<uint8_t, 32>,  */
+/* one AVX2 register or two SSE2 or NEON registers. To add a check, add a     */
+/* function with C linkage and its CHECK-LABEL block.                         */
+/*                                                                            */
+/* Functions under Wide Masks only have a label: masks of more than 64 lanes  */
+/* have no bitfield form and take the lane loops, and the check is that they  */
+/* compile at every ISA level.                                                */
+/*                                                                            */
+/*============================================================================*/
+
+/* Standard Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Sforzinda Includes */
+#include "scl.hpp"
+
+namespace {
+
+using namespace sf::scl;
+
+using f32x8  = simd<float, 8>;
+using f32x4  = simd<float, 4>;
+using i32x8  = simd<std::int32_t, 8>;
+using u8x32  = simd<std::uint8_t, 32>;
+using u8x128 = simd<std::uint8_t, 128>;
+
+template<typename V>
+inline V
+load(const typename V::value_type* ptr) {
+    V v;
+    v.load(ptr);
+    return v;
+}
+
+} /* namespace */
+
+extern "C" {
+
+/*------------*/
+/* Arithmetic */
+/*------------*/
+
+// CHECK-LABEL: scl_add_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?addps}}
+// A64:         {{fadd[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfadd\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_add_f32(float* out, const float* a, const float* b) {
+    (load<f32x8>(a) + load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_sub_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?subps}}
+// A64:         {{fsub[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfsub\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_sub_f32(float* out, const float* a, const float* b) {
+    (load<f32x8>(a) - load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_mul_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?mulps}}
+// A64:         {{fmul[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfmul\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_mul_f32(float* out, const float* a, const float* b) {
+    (load<f32x8>(a) * load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_div_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?(div|rcp)ps}}
+// A64:         {{fdiv[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfdiv\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_div_f32(float* out, const float* a, const float* b) {
+    (load<f32x8>(a) / load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_neg_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?xorps}}
+// A64:         {{fneg[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfneg\.v|vfsgnjn\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_neg_f32(float* out, const float* a) {
+    (-load<f32x8>(a)).store(out);
+}
+
+// CHECK-LABEL: scl_fma_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{vfmadd[0-9]+ps|mulps}}
+// A64:         {{fmla[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfmadd\.vv|vfmacc\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_fma_f32(float* out, const float* a, const float* b, const float* c) {
+    fma(load<f32x8>(a), load<f32x8>(b), load<f32x8>(c)).store(out);
+}
+
+// CHECK-LABEL: scl_min_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?minps}}
+// A64:         {{(fmin|fminnm|fcmgt|fcmlt)[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfmin\.vv|vmflt\.vv|vmfgt\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_min_f32(float* out, const float* a, const float* b) {
+    min(load<f32x8>(a), load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_add_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?paddd}}
+// A64:         {{add[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vadd\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_add_i32(std::int32_t* out, const std::int32_t* a, const std::int32_t* b) {
+    (load<i32x8>(a) + load<i32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_mul_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?pmul(ld|udq)}}
+// A64:         {{mul[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vmul\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_mul_i32(std::int32_t* out, const std::int32_t* a, const std::int32_t* b) {
+    (load<i32x8>(a) * load<i32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_add_u8:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?paddb}}
+// A64:         {{add[[:space:]]+v[0-9]+\.16b}}
+// RVV:         {{vadd\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_add_u8(std::uint8_t* out, const std::uint8_t* a, const std::uint8_t* b) {
+    (load<u8x32>(a) + load<u8x32>(b)).store(out);
+}
+
+/*----------------------*/
+/* Bitwise and Shifting */
+/*----------------------*/
+
+// CHECK-LABEL: scl_and_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?pand}}
+// A64:         {{and[[:space:]]+v[0-9]+\.16b}}
+// RVV:         {{vand\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_and_i32(std::int32_t* out, const std::int32_t* a, const std::int32_t* b) {
+    (load<i32x8>(a) & load<i32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_or_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?por}}
+// A64:         {{orr[[:space:]]+v[0-9]+\.16b}}
+// RVV:         {{vor\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_or_i32(std::int32_t* out, const std::int32_t* a, const std::int32_t* b) {
+    (load<i32x8>(a) | load<i32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_xor_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?pxor}}
+// A64:         {{eor[[:space:]]+v[0-9]+\.16b}}
+// RVV:         {{vxor\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_xor_i32(std::int32_t* out, const std::int32_t* a, const std::int32_t* b) {
+    (load<i32x8>(a) ^ load<i32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_shl_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?pslld}}
+// A64:         {{shl[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vsll\.vi}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_shl_i32(std::int32_t* out, const std::int32_t* a) {
+    (load<i32x8>(a) << 3).store(out);
+}
+
+// CHECK-LABEL: scl_shr_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?psrad}}
+// A64:         {{sshr[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vsra\.vi}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_shr_i32(std::int32_t* out, const std::int32_t* a) {
+    (load<i32x8>(a) >> 3).store(out);
+}
+
+/*----------*/
+/* Rounding */
+/*----------*/
+
+// CHECK-LABEL: scl_floor_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86-SSE41:   {{v?roundps|vrndscaleps}}
+// A64:         {{frintm[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfadd\.v[vf]|vfcvt\.}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_floor_f32(float* out, const float* a) {
+    floor(load<f32x8>(a)).store(out);
+}
+
+// CHECK-LABEL: scl_trunc_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86-SSE2:    {{v?(add|sub)ps}}
+// X86-SSE2:    {{v?(add|sub)ps}}
+// X86-SSE41:   {{v?roundps|vrndscaleps}}
+// A64:         {{frintz[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfadd\.v[vf]|vfcvt\.}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_trunc_f32(float* out, const float* a) {
+    trunc(load<f32x8>(a)).store(out);
+}
+
+/*-------------------------------------------------*/
+/* Selection, Blending, Permutation, and Swizzling */
+/*-------------------------------------------------*/
+
+// CHECK-LABEL: scl_select_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?cmp(lt)?ps}}
+// A64:         {{fcm(gt|lt)[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vmf(lt|gt)\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_select_f32(float* out, const float* a, const float* b) {
+    const f32x8 x = load<f32x8>(a);
+    const f32x8 y = load<f32x8>(b);
+    select<float, 8>(x < y, x, y).store(out);
+}
+
+// CHECK-LABEL: scl_blend_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{[[:space:]]v?[a-z0-9]+ps[[:space:]]}}
+// A64:         {{[[:space:]]v[0-9]+\.(4s|16b|2d|s)}}
+// RVV:         {{[[:space:]]v[0-9]+,}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_blend_f32(float* out, const float* a, const float* b) {
+    blend<0, 9, 2, 11, 4, 13, 6, 15>(load<f32x8>(a), load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_permute_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?(shufps|pshufd|permd|permps)}}
+// A64:         {{[[:space:]]v[0-9]+\.(4s|16b|2d|s)}}
+// RVV:         {{[[:space:]]v[0-9]+,}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_permute_f32(float* out, const float* a) {
+    permute<7, 6, 5, 4, 3, 2, 1, 0>(load<f32x8>(a)).store(out);
+}
+
+// CHECK-LABEL: scl_shuffle_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{[[:space:]]v?[a-z0-9]+ps[[:space:]]}}
+// A64:         {{[[:space:]]v[0-9]+\.(4s|16b|2d|s)}}
+// RVV:         {{[[:space:]]v[0-9]+,}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_shuffle_f32(float* out, const float* a, const float* b) {
+    shuffle<0, 8, 1, 9, 2, 10, 3, 11>(load<f32x8>(a), load<f32x8>(b)).store(out);
+}
+
+// CHECK-LABEL: scl_split_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{%[xy]mm[0-9]+}}
+// A64:         {{[[:space:]]q[0-9]+,}}
+// RVV:         {{[[:space:]]v[0-9]+,}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_split_f32(float* lo, float* hi, const float* a) {
+    const auto [l, h] = split(load<f32x8>(a));
+    l.store(lo);
+    h.store(hi);
+}
+
+// CHECK-LABEL: scl_merge_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{%[xy]mm[0-9]+}}
+// A64:         {{[[:space:]]q[0-9]+,}}
+// RVV:         {{[[:space:]]v[0-9]+,}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+void
+scl_merge_f32(float* out, const float* a, const float* b) {
+    merge(load<f32x4>(a), load<f32x4>(b)).store(out);
+}
+
+/*------------*/
+/* Reductions */
+/*------------*/
+
+// CHECK-LABEL: scl_horizontal_sum_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?addps}}
+// A64:         {{fadd[[:space:]]+v[0-9]+\.4s|faddp}}
+// RVV:         {{vfadd\.vv|vfred(u|o)?sum}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+float
+scl_horizontal_sum_f32(const float* a) {
+    return load<f32x8>(a).horizontal_sum();
+}
+
+// CHECK-LABEL: scl_horizontal_min_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?minps}}
+// A64:         {{(fmin|fminnm|fcmgt|fminp|fminv)[[:space:]]+v[0-9]+}}
+// RVV:         {{vfmin\.vv|vmflt\.vv|vmfgt\.vv|vfredmin}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+float
+scl_horizontal_min_f32(const float* a) {
+    return load<f32x8>(a).horizontal_min();
+}
+
+// CHECK-LABEL: scl_horizontal_sum_i32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?paddd}}
+// A64:         {{(add[[:space:]]+v[0-9]+\.4s|addv|addp)}}
+// RVV:         {{vadd\.vv|vredsum}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+std::int32_t
+scl_horizontal_sum_i32(const std::int32_t* a) {
+    return load<i32x8>(a).horizontal_sum();
+}
+
+// CHECK-LABEL: scl_dot_product_f32:
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+// X86:         {{v?mulps}}
+// A64:         {{(fmul|fmla)[[:space:]]+v[0-9]+\.4s}}
+// RVV:         {{vfmul\.vv|vfmacc\.vv|vfmadd\.vv}}
+// CHECK-NOT:   {{^\.L(BB)?[0-9_]+:}}
+float
+scl_dot_product_f32(const float* a, const float* b) {
+    return f32x8::dot_product(load<f32x8>(a), load<f32x8>(b));
+}
+
+/*------------*/
+/* Wide Masks */
+/*------------*/
+
+// CHECK-LABEL: scl_compress_u8x128:
+void
+scl_compress_u8x128(std::uint8_t* out, const std::uint8_t* a, std::uint8_t b) {
+    const u8x128 x = load<u8x128>(a);
+    compress(x, x < b).store(out);
+}
+
+// CHECK-LABEL: scl_compress_store_u8x128:
+std::size_t
+scl_compress_store_u8x128(std::uint8_t* out, const std::uint8_t* a, std::uint8_t b) {
+    const u8x128 x = load<u8x128>(a);
+    return compress_store(out, x, x < b);
+}
+
+} /* extern "C" */
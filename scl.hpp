@@ -18,19 +18,361 @@
 #include <iostream>
 #include <cmath>
 #include <array>
+#include <utility>
+#include <bit>
+#include <new>
+#include <limits>
+#include <atomic>
+
+#if defined(SCL_PROFILE)
+    #include <iomanip>
+#endif
 
 /* Sforzinda Includes */
 #include "sf_base.hpp"
 
+/* Platform Includes */
+#if defined(SF_ISA_SSE2)
+    #include <immintrin.h>
+#endif
+#if defined(SF_ISA_NEON)
+    #include <arm_neon.h>
+#endif
+
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* Instruction Set Namespace                                                  */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Everything in scl except the profiling counters and the dispatch table is  */
+/* declared in an inline namespace named after the instruction sets the       */
+/* translation unit is compiled for, e.g. isa_avx512_bw_cd_dq_vl_fma_f16c for */
+/* -march=x86-64-v4. Inline functions and template instances built with      */
+/* different flags then have different symbols, so the linker cannot merge   */
+/* an AVX-512 copy of scl::reduce into a translation unit built for SSE2.    */
+/* Code still names everything as scl::..., but scl types are distinct types */
+/* in each variant and must not be passed between them.                     */
+/*                                                                            */
+/* The name covers the SF_ISA_* levels and the extensions scl tests for.     */
+/* Translation units whose flags differ only in extensions scl does not use  */
+/* share a namespace, which is harmless since their scl code is identical.   */
+/*                                                                            */
+/*============================================================================*/
+
+#if defined(SF_ISA_AVX512F)
+   #define SCL_ISA_LEVEL       avx512
+#elif defined(SF_ISA_AVX2)
+   #define SCL_ISA_LEVEL       avx2
+#elif defined(SF_ISA_AVX)
+   #define SCL_ISA_LEVEL       avx
+#elif defined(__SSE4_1__)
+   #define SCL_ISA_LEVEL       sse41
+#elif defined(SF_ISA_SSE2)
+   #define SCL_ISA_LEVEL       sse2
+#elif defined(SF_ISA_SVE) && defined(__ARM_FEATURE_SVE_BITS) && \
+      __ARM_FEATURE_SVE_BITS > 0
+   #define SCL_ISA_LEVEL       scl_isa_cat(sve, __ARM_FEATURE_SVE_BITS)
+#elif defined(SF_ISA_SVE)
+   #define SCL_ISA_LEVEL       sve
+#elif defined(SF_ISA_NEON)
+   #define SCL_ISA_LEVEL       neon
+#elif defined(SF_ISA_RVV) && defined(__riscv_v_fixed_vlen)
+   #define SCL_ISA_LEVEL       scl_isa_cat(rvv, __riscv_v_fixed_vlen)
+#elif defined(SF_ISA_RVV)
+   #define SCL_ISA_LEVEL       rvv
+#elif defined(SF_ISA_WASM_SIMD128)
+   #define SCL_ISA_LEVEL       wasm
+#elif defined(__VSX__)
+   #define SCL_ISA_LEVEL       vsx
+#elif defined(SF_ISA_ALTIVEC)
+   #define SCL_ISA_LEVEL       altivec
+#else
+   #define SCL_ISA_LEVEL       generic
+#endif
+
+/* One name part per extension, empty when the extension is off. */
+#if defined(__AVX512BW__)
+   #define SCL_ISA_BW          _bw
+#else
+   #define SCL_ISA_BW
+#endif
+#if defined(__AVX512CD__)
+   #define SCL_ISA_CD          _cd
+#else
+   #define SCL_ISA_CD
+#endif
+#if defined(__AVX512DQ__)
+   #define SCL_ISA_DQ          _dq
+#else
+   #define SCL_ISA_DQ
+#endif
+#if defined(__AVX512VL__)
+   #define SCL_ISA_VL          _vl
+#else
+   #define SCL_ISA_VL
+#endif
+#if defined(__AVX512VBMI__)
+   #define SCL_ISA_VBMI        _vbmi
+#else
+   #define SCL_ISA_VBMI
+#endif
+#if defined(__AVX512VBMI2__)
+   #define SCL_ISA_VBMI2       _vbmi2
+#else
+   #define SCL_ISA_VBMI2
+#endif
+#if defined(__AVX512BITALG__)
+   #define SCL_ISA_BITALG      _bitalg
+#else
+   #define SCL_ISA_BITALG
+#endif
+#if defined(__AVX512VPOPCNTDQ__)
+   #define SCL_ISA_VPOPCNTDQ   _vpopcntdq
+#else
+   #define SCL_ISA_VPOPCNTDQ
+#endif
+#if defined(SF_ISA_FMA)
+   #define SCL_ISA_FMA         _fma
+#else
+   #define SCL_ISA_FMA
+#endif
+#if defined(SF_ISA_F16C)
+   #define SCL_ISA_F16C        _f16c
+#else
+   #define SCL_ISA_F16C
+#endif
+#if defined(SF_ISA_FP16)
+   #define SCL_ISA_FP16        _fp16
+#else
+   #define SCL_ISA_FP16
+#endif
+
+/* Pastes its arguments into one token after expanding them. */
+#define scl_isa_cat(a, b)      scl_isa_cat_(a, b)
+#define scl_isa_cat_(a, b)     a##b
+#define scl_isa_join(a, b, c, d, e, f, g, h, i, j, k, l) \
+        scl_isa_join_(a, b, c, d, e, f, g, h, i, j, k, l)
+#define scl_isa_join_(a, b, c, d, e, f, g, h, i, j, k, l) \
+        a##b##c##d##e##f##g##h##i##j##k##l
+
+#define SCL_ISA_NAMESPACE \
+        scl_isa_join(scl_isa_cat(isa_, SCL_ISA_LEVEL), SCL_ISA_BW, SCL_ISA_CD, \
+                     SCL_ISA_DQ, SCL_ISA_VL, SCL_ISA_VBMI, SCL_ISA_VBMI2,      \
+                     SCL_ISA_BITALG, SCL_ISA_VPOPCNTDQ, SCL_ISA_FMA,           \
+                     SCL_ISA_F16C, SCL_ISA_FP16)
+
 namespace sf  {
 namespace scl {
 
+/*-----------*/
+/* Profiling */
+/*-----------*/
+
+/* With SCL_PROFILE defined, the operations below count their calls, and */
+/* the masked and partial ones also count how many of their lanes were  */
+/* active. The *_loop counters are the lane-by-lane fallbacks taken when */
+/* the target has no instruction for the shape, and the *_emulated ones  */
+/* the bit operations built from shifts and byte lookups for the same    */
+/* reason; lane_access counts each operator[] and set. Counters are      */
+/* relaxed atomics shared by all threads. Without SCL_PROFILE the hooks  */
+/* expand to nothing.                                                    */
+/*                                                                       */
+/*     scl::profile::dump(std::cerr);                                    */
+/*     scl::profile::reset();                                            */
+#if defined(SCL_PROFILE)
+
+namespace profile {
+
+enum class counter : std::size_t {
+    lane_access,
+    to_bitfield_loop,
+    gather_loop,
+    scatter_loop,
+    compress_loop,
+    lookup_loop,
+    popcount_emulated,
+    countl_zero_emulated,
+    countr_zero_emulated,
+    load_partial,
+    store_partial,
+    masked_load,
+    masked_store,
+    masked_gather,
+    masked_scatter,
+    compress,
+    count
+};
+
+inline constexpr const char* counter_names[] = {
+    "lane_access",
+    "to_bitfield_loop",
+    "gather_loop",
+    "scatter_loop",
+    "compress_loop",
+    "lookup_loop",
+    "popcount_emulated",
+    "countl_zero_emulated",
+    "countr_zero_emulated",
+    "load_partial",
+    "store_partial",
+    "masked_load",
+    "masked_store",
+    "masked_gather",
+    "masked_scatter",
+    "compress",
+};
+
+static_assert(std::size(counter_names) == std::size_t(counter::count),
+              "every profile counter needs a name");
+
+/* Calls, and for masked operations the active and total lanes. */
+struct statistics {
+    std::uint64_t calls        = 0;
+    std::uint64_t active_lanes = 0;
+    std::uint64_t lanes        = 0;
+
+    /* Average fraction of active lanes, or 1 if no lanes were counted. */
+    double 
+    active_ratio() const {
+        return lanes ? double(active_lanes) / double(lanes) : 1.0;
+    }
+};
+
+namespace detail {
+
+struct entry {
+    std::atomic<std::uint64_t> calls        {0};
+    std::atomic<std::uint64_t> active_lanes {0};
+    std::atomic<std::uint64_t> lanes        {0};
+};
+
+inline std::array<entry, std::size_t(counter::count)> entries;
+
+} /* namespace detail */
+
+inline void 
+record(counter c) {
+    detail::entries[std::size_t(c)].calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void 
+record(counter c, std::size_t active, std::size_t lanes) {
+    detail::entry& e = detail::entries[std::size_t(c)];
+    e.calls.fetch_add(1, std::memory_order_relaxed);
+    e.active_lanes.fetch_add(active, std::memory_order_relaxed);
+    e.lanes.fetch_add(lanes, std::memory_order_relaxed);
+}
+
+/* Lanes of a mask that are set. */
+template<typename Mask>
+inline std::size_t 
+active_lanes(const Mask& mask, std::size_t n) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+         count += mask.data[i] != 0;
+    }
+    return count;
+}
+
+inline statistics 
+get(counter c) {
+    const detail::entry& e = detail::entries[std::size_t(c)];
+    return statistics { e.calls.load(std::memory_order_relaxed),
+                        e.active_lanes.load(std::memory_order_relaxed),
+                        e.lanes.load(std::memory_order_relaxed) };
+}
+
+inline void 
+reset() {
+    for (detail::entry& e : detail::entries) {
+         e.calls.store(0, std::memory_order_relaxed);
+         e.active_lanes.store(0, std::memory_order_relaxed);
+         e.lanes.store(0, std::memory_order_relaxed);
+    }
+}
+
+/* One line per counter that was hit: calls, and the active-lane ratio */
+/* for counters that track lanes.                                      */
+inline void 
+dump(std::ostream& os) {
+    const std::ios_base::fmtflags flags     = os.flags();
+    const std::streamsize         precision = os.precision();
+    os << std::left << std::setw(22) << "operation" 
+       << std::right << std::setw(14) << "calls" 
+       << std::setw(16) << "active lanes" << '\n';
+    for (std::size_t i = 0; i < std::size_t(counter::count); ++i) {
+        const statistics s = get(counter(i));
+        if (s.calls == 0) {
+            continue;
+        }
+        os << std::left << std::setw(22) << counter_names[i] 
+           << std::right << std::setw(14) << s.calls;
+        if (s.lanes) {
+            os << std::setw(15) << std::fixed << std::setprecision(1) 
+               << 100.0 * s.active_ratio() << '%';
+        }
+        os << '\n';
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} /* namespace profile */
+
+/* Hooks for the counters above. Constant evaluation is not counted. */
+#define scl_profile_count(c) \
+    do { \
+        if (!std::is_constant_evaluated()) \
+            ::sf::scl::profile::record(::sf::scl::profile::counter::c); \
+    } while (0)
+
+#define scl_profile_lanes(c, active, total) \
+    do { \
+        if (!std::is_constant_evaluated()) \
+            ::sf::scl::profile::record(::sf::scl::profile::counter::c, \
+                                       (active), (total)); \
+    } while (0)
+
+#else
+    #define scl_profile_count(c)                ((void)0)
+    #define scl_profile_lanes(c, active, total) ((void)0)
+#endif
+
+inline namespace SCL_ISA_NAMESPACE {
+
+/* 16-bit floating-point lane types, where the compiler has them: IEEE    */
+/* half precision (std::float16_t in C++23) and bfloat16, the upper half  */
+/* of a float. Their arithmetic is native with SF_ISA_FP16 and otherwise  */
+/* goes through float. std::is_floating_point is false for both before    */
+/* C++23, so library code tests detail::is_half_float.                    */
+#if defined(SF_HAS_FLOAT16)
+    using float16_t  = _Float16;
+#endif
+#if defined(SF_HAS_BFLOAT16)
+    using bfloat16_t = __bf16;
+#endif
+
+namespace detail {
+
+template<typename T>
+inline constexpr bool is_half_float = false;
+
+#if defined(SF_HAS_FLOAT16)
+    template<> inline constexpr bool is_half_float<float16_t>  = true;
+#endif
+#if defined(SF_HAS_BFLOAT16)
+    template<> inline constexpr bool is_half_float<bfloat16_t> = true;
+#endif
+
+} /* namespace detail */
+
 template <typename T, std::size_t N>
 class simd {
 public:
 
-    static_assert(std::is_arithmetic<T>::value, 
-                  "simd<T, N> requires arithmetic types");
+    static_assert(std::is_arithmetic<T>::value || detail::is_half_float<T>,
+                  "simd<T, N> requires arithmetic or 16-bit floating-point types");
 
     static_assert(N > 0, 
                   "simd<T, N> size N must be greater than zero");
@@ -39,10 +381,18 @@ public:
 
     using value_type        = T;
 
+    /* Mask lanes are as wide as the lanes they select, so that select  */
+    /* stays one register wide and a Clang vector comparison converts   */
+    /* to mask_type as is: 16 bits for half precision, 32 for float and */
+    /* 64 for double.                                                   */
     using mask_element_type = 
     typename std::conditional<std::is_integral<T>::value,
              T, 
-             std::int32_t>::type;
+    typename std::conditional<detail::is_half_float<T>,
+             std::int16_t, 
+    typename std::conditional<sizeof(T) == 8,
+             std::int64_t,
+             std::int32_t>::type>::type>::type;
 
     #if defined(__clang__)
         using vector_type = T __attribute__((vector_size(sizeof(T) * N)));
@@ -51,6 +401,14 @@ public:
         std::array<T, N> data;
     #endif
 
+    /* Alignment in bytes assumed by load_aligned, store_aligned and stream. */
+    #if defined(__clang__)
+        static constexpr std::size_t alignment = alignof(vector_type);
+    #else
+        static constexpr std::size_t alignment = 
+        std::bit_floor(sizeof(T) * N) < 64 ? std::bit_floor(sizeof(T) * N) : 64;
+    #endif
+
 public:
 
     /*------------------------------------------*/
@@ -79,10 +437,14 @@ public:
 
         mask_type() = default;
 
+        /* Any nonzero lane counts as set and is stored as all ones, the */
+        /* form the movemask and blend paths test. Lanes written through */
+        /* data directly must already be all ones or zero.               */
         #if defined(__clang__)
-            mask_type(const vector_type& v) : data(v) {}
+            constexpr mask_type(const vector_type& v) : data(normalize(v)) {}
         #else
-            mask_type(const std::array<element_type, N>& arr) : data(arr) {}
+            constexpr mask_type(const std::array<element_type, N>& arr) 
+            : data(normalize(arr)) {}
         #endif
 
         /*----------------------*/
@@ -92,13 +454,13 @@ public:
         #if defined(__clang__)
             constexpr mask_type& 
             operator=(const vector_type& v) {
-                data = v;
+                data = normalize(v);
                 return *this;
             }
         #else
             constexpr mask_type& 
             operator=(const std::array<element_type, N>& arr) {
-                data = arr;
+                data = normalize(arr);
                 return *this;
             }
         #endif
@@ -116,75 +478,82 @@ public:
             #endif
         }
 
-        explicit 
+        /* True if any lane is set. ORs every lane instead of branching */
+        /* on each, so the loop vectorizes.                             */
+        explicit constexpr 
         operator bool() const {
+            element_type any = 0;
             for (std::size_t i = 0; i < N; ++i) {
-                #if defined(__clang__)
-                    if (data[i]) return true;
-                #else
-                    if (data.at(i)) return true;
-                #endif
+                 any |= data[i];
             }
-            return false;
+            return any != 0;
         }
 
         /*-------------------*/
         /* Logical Operators */
         /*-------------------*/
 
-        mask_type 
+        constexpr mask_type 
         operator~() const {
             #if defined(__clang__)
-                return mask_type{~data};
+                mask_type result;
+                result.data = ~data;
+                return result;
             #else
-                std::array<element_type, N> result;
+                mask_type result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = ~data[i];
+                     result.data[i] = ~data[i];
                 }
-                return mask_type{result};
+                return result;
             #endif
         }
 
-        mask_type 
+        constexpr mask_type 
         operator&(const mask_type& rhs) const {
             #if defined(__clang__)
-                return mask_type{data & rhs.data};
+                mask_type result;
+                result.data = data & rhs.data;
+                return result;
             #else
-                std::array<element_type, N> result;
+                mask_type result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = data[i] & rhs.data[i];
+                     result.data[i] = data[i] & rhs.data[i];
                 }
-                return mask_type{result};
+                return result;
             #endif
         }
 
-        mask_type 
+        constexpr mask_type 
         operator|(const mask_type& rhs) const {
             #if defined(__clang__)
-                return mask_type{data | rhs.data};
+                mask_type result;
+                result.data = data | rhs.data;
+                return result;
             #else
-                std::array<element_type, N> result;
+                mask_type result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = data[i] | rhs.data[i];
+                     result.data[i] = data[i] | rhs.data[i];
                 }
-                return mask_type{result};
+                return result;
             #endif
         }
 
-        mask_type 
+        constexpr mask_type 
         operator^(const mask_type& rhs) const {
             #if defined(__clang__)
-                return mask_type{data ^ rhs.data};
+                mask_type result;
+                result.data = data ^ rhs.data;
+                return result;
             #else
-                std::array<element_type, N> result;
+                mask_type result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = data[i] ^ rhs.data[i];
+                     result.data[i] = data[i] ^ rhs.data[i];
                 }
-                return mask_type{result};
+                return result;
             #endif
         }
 
-        mask_type& 
+        constexpr mask_type& 
         operator&=(const mask_type& rhs) {
             #if defined(__clang__)
                 data &= rhs.data;
@@ -196,7 +565,7 @@ public:
             return *this;
         }
 
-        mask_type& 
+        constexpr mask_type& 
         operator|=(const mask_type& rhs) {
             #if defined(__clang__)
                 data |= rhs.data;
@@ -208,7 +577,7 @@ public:
             return *this;
         }
 
-        mask_type& operator^=(const mask_type& rhs) {
+        constexpr mask_type& operator^=(const mask_type& rhs) {
             #if defined(__clang__)
                 data ^= rhs.data;
             #else
@@ -234,8 +603,95 @@ public:
             return os;
         }
 
+    private:
+
+        #if defined(__clang__)
+            static constexpr vector_type 
+            normalize(const vector_type& v) {
+                return (vector_type)(v != 0);
+            }
+        #else
+            static constexpr std::array<element_type, N> 
+            normalize(const std::array<element_type, N>& arr) {
+                std::array<element_type, N> result;
+                for (std::size_t i = 0; i < N; ++i) {
+                     result[i] = arr[i] ? element_type(~0) : element_type(0);
+                }
+                return result;
+            }
+        #endif
+
     }; // end of mask_type
 
+    /*-----------------------------------------*/
+    /* Nested Lane Reference for Element Writes */
+    /*-----------------------------------------*/
+
+    #if defined(__clang__)
+        /* Vector elements cannot be bound to T&, so non-const operator[] */
+        /* returns this proxy. Each read is one extract and each write is */
+        /* one insert into the owning vector; nothing is shared between   */
+        /* vectors, so it is safe to use from multiple threads.           */
+        class reference {
+        public:
+
+            constexpr reference(simd& owner, std::size_t idx) 
+                : owner(owner), idx(idx) {}
+
+            constexpr reference(const reference&) = default;
+
+            constexpr 
+            operator T() const {
+                return owner.data[idx];
+            }
+
+            constexpr reference& 
+            operator=(T value) {
+                owner.data[idx] = value;
+                return *this;
+            }
+
+            /* Copy the referenced lane's value, not the reference itself. */
+            constexpr reference& 
+            operator=(const reference& rhs) {
+                owner.data[idx] = T(rhs);
+                return *this;
+            }
+
+            constexpr reference& 
+            operator+=(T value) {
+                owner.data[idx] += value;
+                return *this;
+            }
+
+            constexpr reference& 
+            operator-=(T value) {
+                owner.data[idx] -= value;
+                return *this;
+            }
+
+            constexpr reference& 
+            operator*=(T value) {
+                owner.data[idx] *= value;
+                return *this;
+            }
+
+            constexpr reference& 
+            operator/=(T value) {
+                owner.data[idx] /= value;
+                return *this;
+            }
+
+        private:
+
+            simd&       owner;
+            std::size_t idx;
+
+        }; // end of reference
+    #else
+        using reference = T&;
+    #endif
+
 public:
 
     /*--------------*/
@@ -245,7 +701,7 @@ public:
     simd() = default;
 
     /* Initialize all elements with a scalar value. */
-    explicit simd(T scalar) {
+    explicit constexpr simd(T scalar) {
         #if defined(__clang__)
             data = vector_type{};
             data += scalar;
@@ -256,13 +712,13 @@ public:
 
     /* Construct with a vector type. */
     #if defined(__clang__)
-        simd(const vector_type& vec) : data(vec) {}
+        constexpr simd(const vector_type& vec) : data(vec) {}
     #else
-        simd(const std::array<T, N>& arr) : data(arr) {}
+        constexpr simd(const std::array<T, N>& arr) : data(arr) {}
     #endif
 
     /* Construct with an initializer list. */
-    explicit 
+    explicit constexpr 
     simd(std::initializer_list<T> init) {
         #if defined(__clang__)
             data = vector_type{};
@@ -275,7 +731,7 @@ public:
 
     /* Construct with an array. */
     template <std::size_t M>
-    explicit 
+    explicit constexpr 
     simd(const std::array<T, M>& arr) {
         #if defined(__clang__)
             data = vector_type{};
@@ -290,7 +746,7 @@ public:
     /* Type Conversion Constructors */
     /*------------------------------*/
 
-    explicit 
+    explicit constexpr 
     operator bool() const {
         for (std::size_t i = 0; i < N; ++i) {
             #if defined(__clang__)
@@ -302,26 +758,19 @@ public:
         return false;
     }
 
-    explicit
+    explicit constexpr
     operator std::array<T, N>() const {
-        #if defined(__clang__)
-            return data;
-        #else
-            return data;
-        #endif
+        return data;
     }
 
     /*----------------------*/
     /* Assignment Operators */
     /*----------------------*/
 
-    simd& 
-    operator=(const simd& rhs) {
-        data = rhs.data;
-        return *this;
-    }
+    constexpr simd& 
+    operator=(const simd& rhs) = default;
 
-    simd& 
+    constexpr simd& 
     operator=(T scalar) {
         #if defined(__clang__)
             data = vector_type{};
@@ -332,7 +781,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator=(std::initializer_list<T> init) {
         #if defined(__clang__)
             data = vector_type{};
@@ -347,7 +796,7 @@ public:
     }
 
     template<std::size_t M>
-    simd& 
+    constexpr simd& 
     operator=(const std::array<T, M>& arr) {
         #if defined(__clang__)
             data = vector_type{};
@@ -365,8 +814,9 @@ public:
     /* Indexing Operators */
     /*--------------------*/
 
-    T 
+    constexpr T 
     operator[](std::size_t idx) const {
+        scl_profile_count(lane_access);
         #if defined(__clang__)
             return data[idx];
         #else
@@ -374,44 +824,148 @@ public:
         #endif
     }
 
-    T& 
+    constexpr reference 
     operator[](std::size_t idx) {
+        scl_profile_count(lane_access);
         #if defined(__clang__)
-            /* Union to access elements of vector type. */
-            union {
-                vector_type v;
-                T           e[N];
-            } u;
-
-            static T temp;
-                   u.v      = data;
-                   temp     = u.e[idx];
-                   u.e[idx] = temp;
-                   data = u.v;
-            return temp;
+            return reference(*this, idx);
         #else
             return data.at(idx);
         #endif
     }
 
+    /* Extract lane I, checked at compile time. */
+    template<std::size_t I>
+    constexpr T 
+    get() const {
+        static_assert(I < N, "Lane index out of range for simd size");
+        return data[I];
+    }
+
+    /* Insert value into lane idx. */
+    constexpr void 
+    set(std::size_t idx, T value) {
+        scl_profile_count(lane_access);
+        data[idx] = value;
+    }
+
+    /* Load N elements. memcpy cannot be constant-evaluated, so constant */
+    /* expressions take an element-wise copy instead.                    */
     constexpr void 
     load(const T* ptr) {
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < N; ++i) {
+                 data[i] = ptr[i];
+            }
+            return;
+        }
         #if defined(__clang__)
             std::memcpy(&data, ptr, sizeof(vector_type));
         #else
+            #if defined(SF_ISA_AVX)
+            /* GCC expands memcpy in 16-byte pieces, and a 32-byte operation */
+            /* on the copy cannot be forwarded from two 16-byte stores.      */
+            if constexpr (sizeof(T) * N % 32 == 0) {
+                const char* src = reinterpret_cast<const char*>(ptr);
+                char*       dst = reinterpret_cast<char*>(data.data());
+                for (std::size_t i = 0; i < sizeof(T) * N; i += 32) {
+                     _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+                }
+                return;
+            }
+            #endif
             std::memcpy(data.data(), ptr, sizeof(T) * N);
         #endif
     }
 
+    /* Store N elements, element-wise in constant expressions like load. */
     constexpr void 
     store(T* ptr) const {
+        if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < N; ++i) {
+                 ptr[i] = data[i];
+            }
+            return;
+        }
         #if defined(__clang__)
             std::memcpy(ptr, &data, sizeof(vector_type));
         #else
+            #if defined(SF_ISA_AVX)
+            /* Whole registers, as in load. */
+            if constexpr (sizeof(T) * N % 32 == 0) {
+                const char* src = reinterpret_cast<const char*>(data.data());
+                char*       dst = reinterpret_cast<char*>(ptr);
+                for (std::size_t i = 0; i < sizeof(T) * N; i += 32) {
+                     _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+                }
+                return;
+            }
+            #endif
             std::memcpy(ptr, data.data(), sizeof(T) * N);
         #endif
     }
 
+    /* Load from memory aligned to simd::alignment bytes. */
+    constexpr void 
+    load_aligned(const T* ptr) {
+        load(static_cast<const T*>(sf_assume_aligned(ptr, alignment)));
+    }
+
+    /* Store to memory aligned to simd::alignment bytes. */
+    constexpr void 
+    store_aligned(T* ptr) const {
+        store(static_cast<T*>(sf_assume_aligned(ptr, alignment)));
+    }
+
+    /* Non-temporal store to memory aligned to simd::alignment bytes. The */
+    /* write bypasses the cache, so buffers that are filled once and not  */
+    /* read back soon skip the read-for-ownership of each line. Call      */
+    /* stream_fence() before the data is consumed by another thread.      */
+    void 
+    stream(T* ptr) const {
+        #if defined(__clang__)
+            __builtin_nontemporal_store(data, static_cast<vector_type*>(
+                sf_assume_aligned(static_cast<void*>(ptr), alignment)));
+        #elif defined(SF_ISA_SSE2)
+            constexpr std::size_t bytes = sizeof(T) * N;
+            const char* src = reinterpret_cast<const char*>(data.data());
+            char*       dst = reinterpret_cast<char*>(ptr);
+            #if defined(SF_ISA_AVX512F)
+            if constexpr (bytes % 64 == 0) {
+                for (std::size_t i = 0; i < bytes; i += 64) {
+                     _mm512_stream_si512(
+                        reinterpret_cast<__m512i*>(dst + i),
+                        _mm512_loadu_si512(src + i));
+                }
+            } else
+            #endif
+            #if defined(SF_ISA_AVX)
+            if constexpr (bytes % 32 == 0) {
+                for (std::size_t i = 0; i < bytes; i += 32) {
+                     _mm256_stream_si256(
+                        reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_loadu_si256(
+                            reinterpret_cast<const __m256i*>(src + i)));
+                }
+            } else
+            #endif
+            if constexpr (bytes % 16 == 0) {
+                for (std::size_t i = 0; i < bytes; i += 16) {
+                     _mm_stream_si128(
+                        reinterpret_cast<__m128i*>(dst + i),
+                        _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(src + i)));
+                }
+            } else {
+                store_aligned(ptr);
+            }
+        #else
+            store_aligned(ptr);
+        #endif
+    }
+
     constexpr void 
     store_reverse(T* ptr) const {
         for (std::size_t i = 0; i < N; ++i) {
@@ -423,34 +977,72 @@ public:
         }
     }
 
+    /* Load the first count elements and zero the rest. Memory past      */
+    /* ptr[count - 1] is never touched, so loop tails need no padding.    */
+    constexpr void 
+    load_partial(const T* ptr, std::size_t count) {
+        scl_profile_lanes(load_partial, count < N ? count : N, N);
+        for (std::size_t i = 0; i < N; ++i) {
+             data[i] = (i < count) ? ptr[i] : T(0);
+        }
+    }
+
+    /* Store the first count elements, leaving the rest of ptr untouched. */
+    constexpr void 
+    store_partial(T* ptr, std::size_t count) const {
+        scl_profile_lanes(store_partial, count < N ? count : N, N);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (i < count) ptr[i] = data[i];
+        }
+    }
+
+    /* Load elements whose mask lane is set. Inactive lanes keep their    */
+    /* current value and their addresses are never read.                  */
+    constexpr void 
+    masked_load(const T* ptr, const mask_type& mask) {
+        scl_profile_lanes(masked_load, profile::active_lanes(mask, N), N);
+        for (std::size_t i = 0; i < N; ++i) {
+             data[i] = mask.data[i] ? ptr[i] : T(data[i]);
+        }
+    }
+
+    /* Store elements whose mask lane is set. Inactive lanes are skipped. */
+    constexpr void 
+    masked_store(T* ptr, const mask_type& mask) const {
+        scl_profile_lanes(masked_store, profile::active_lanes(mask, N), N);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (mask.data[i]) ptr[i] = data[i];
+        }
+    }
+
     /*------------------------------------------------------*/
     /* Arithmetic Unary and Arithmetic Assignment Operators */
     /*------------------------------------------------------*/
 
     /* Negate all elements. */
-    simd 
+    constexpr simd 
     operator-() const {
         #if defined(__clang__)
             return simd(-data);
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = -data[i];
+                 result.data[i] = -data[i];
             }
-            return simd(result);
+            return result;
         #endif
     }
 
     /* Ensure that the vector is positive. */
-    simd 
+    constexpr simd 
     operator+() const { 
         return *this; 
     }
 
-    simd& 
+    constexpr simd& 
     operator+=(const T& rhs) {
         #if defined(__clang__)
-            data += vector_type { rhs };
+            data += rhs;
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  data[i] += rhs;
@@ -459,10 +1051,10 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator-=(const T& rhs) {
         #if defined(__clang__)
-            data -= vector_type { rhs };
+            data -= rhs;
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  data[i] -= rhs;
@@ -471,10 +1063,10 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator*=(const T& rhs) {
         #if defined(__clang__)
-            data *= vector_type { rhs };
+            data *= rhs;
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  data[i] *= rhs;
@@ -483,10 +1075,10 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator/=(const T& rhs) {
         #if defined(__clang__)
-            data /= vector_type { rhs };
+            data /= rhs;
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  data[i] /= rhs;
@@ -495,7 +1087,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator+=(const simd& rhs) {
         #if defined(__clang__)
             data += rhs.data;
@@ -507,7 +1099,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator-=(const simd& rhs) {
         #if defined(__clang__)
             data -= rhs.data;
@@ -519,7 +1111,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator*=(const simd& rhs) {
         #if defined(__clang__)
             data *= rhs.data;
@@ -531,7 +1123,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator/=(const simd& rhs) {
         #if defined(__clang__)
             data /= rhs.data;
@@ -543,7 +1135,7 @@ public:
         return *this;
     }
 
-    simd& 
+    constexpr simd& 
     operator++() {
         #if defined(__clang__)
             for (std::size_t i = 0; i < N; ++i) {
@@ -557,11 +1149,11 @@ public:
         return *this;
     }
 
-    simd 
+    constexpr simd 
     operator++(std::int32_t) {
         simd temp = *this;
         #if defined(__clang__)
-            data += vector_type { T(1) };
+            data += T(1);
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  ++data[i];
@@ -570,7 +1162,7 @@ public:
         return temp;
     }
 
-    simd& operator--() {
+    constexpr simd& operator--() {
         #if defined(__clang__)
             for (std::size_t i = 0; i < N; ++i) {
                 data[i] -= T(1);
@@ -583,11 +1175,11 @@ public:
         return *this;
     }
 
-    simd 
+    constexpr simd 
     operator--(std::int32_t) {
         simd temp = *this;
         #if defined(__clang__)
-            data -= vector_type { T(1) };
+            data -= T(1);
         #else
             for (std::size_t i = 0; i < N; ++i) {
                  --data[i];
@@ -615,159 +1207,159 @@ public:
     /* Arithmetic Operators */
     /*----------------------*/
 
-    friend simd 
+    friend constexpr simd 
     operator+(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data + rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] + rhs.data[i];
+                 result.data[i] = lhs.data[i] + rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator+(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data + vector_type { rhs } };
+            return simd { lhs.data + rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] + rhs;
+                 result.data[i] = lhs.data[i] + rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator+(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } + rhs.data };
+            return simd { lhs + rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs + rhs.data[i];
+                 result.data[i] = lhs + rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator-(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data - rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] - rhs.data[i];
+                 result.data[i] = lhs.data[i] - rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator-(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data - vector_type { rhs } };
+            return simd { lhs.data - rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] - rhs;
+                 result.data[i] = lhs.data[i] - rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator-(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } - rhs.data};
+            return simd { lhs - rhs.data};
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs - rhs.data[i];
+                 result.data[i] = lhs - rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator*(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data * rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] * rhs.data[i];
+                 result.data[i] = lhs.data[i] * rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator*(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data * vector_type { rhs } };
+            return simd { lhs.data * rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] * rhs;
+                 result.data[i] = lhs.data[i] * rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator*(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } * rhs.data };
+            return simd { lhs * rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs * rhs.data[i];
+                 result.data[i] = lhs * rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator/(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data / rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] / rhs.data[i];
+                 result.data[i] = lhs.data[i] / rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator/(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data / vector_type { rhs } };
+            return simd { lhs.data / rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] / rhs;
+                 result.data[i] = lhs.data[i] / rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator/(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } / rhs.data };
+            return simd { lhs / rhs.data };
         #else
-                std::array<T, N> result;
+                simd result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = lhs / rhs.data[i];
+                     result.data[i] = lhs / rhs.data[i];
                 }
-                return simd { result };
+                return result;
         #endif
     }
 
@@ -775,285 +1367,285 @@ public:
     /* Comparison Operators */
     /*----------------------*/
 
-    friend mask_type 
+    friend constexpr mask_type 
     operator==(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return mask_type { lhs.data == rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] == rhs.data[i]           ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] == rhs.data[i]           ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator==(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data == vector_type { rhs } };
+            return mask_type { lhs.data == rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] == rhs                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] == rhs                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator==(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } == rhs.data };
+            return mask_type { lhs == rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs == rhs.data[i]                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs == rhs.data[i]                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator!=(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return mask_type { lhs.data != rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] != rhs.data[i]           ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] != rhs.data[i]           ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator!=(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data != vector_type { rhs } };
+            return mask_type { lhs.data != rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] != rhs                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] != rhs                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator!=(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } != rhs.data };
+            return mask_type { lhs != rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs != rhs.data[i]                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs != rhs.data[i]                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
 
-    friend mask_type 
+    friend constexpr mask_type 
     operator<(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
-            typename mask_type::vector_type result;
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                result[i] = lhs.data[i] < rhs.data[i]           ? 
-                           ~typename mask_type::element_type(0) : 
-                            typename mask_type::element_type(0);
+                result.data[i] = lhs.data[i] < rhs.data[i]           ? 
+                                ~typename mask_type::element_type(0) : 
+                                 typename mask_type::element_type(0);
             }
-            return mask_type{result};
+            return result;
         #else
-            std::array<typename mask_type::element_type, N> result;
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                result[i] = lhs.data[i] < rhs.data[i]           ? 
-                           ~typename mask_type::element_type(0) : 
-                            typename mask_type::element_type(0);
+                result.data[i] = lhs.data[i] < rhs.data[i]           ? 
+                                ~typename mask_type::element_type(0) : 
+                                 typename mask_type::element_type(0);
             }
-            return mask_type{result};
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator<(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data < vector_type { rhs } };
+            return mask_type { lhs.data < rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] < rhs                    ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] < rhs                    ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator<(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } < rhs.data };
+            return mask_type { lhs < rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs < rhs.data[i]                    ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs < rhs.data[i]                    ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator>(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
-            typename mask_type::vector_type result;
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                result[i] = lhs.data[i] > rhs.data[i]           ? 
-                           ~typename mask_type::element_type(0) : 
-                            typename mask_type::element_type(0);
+                result.data[i] = lhs.data[i] > rhs.data[i]           ? 
+                                ~typename mask_type::element_type(0) : 
+                                 typename mask_type::element_type(0);
             }
-            return mask_type{result};
+            return result;
         #else
-            std::array<typename mask_type::element_type, N> result;
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                result[i] = lhs.data[i] > rhs.data[i]           ? 
-                           ~typename mask_type::element_type(0) : 
-                            typename mask_type::element_type(0);
+                result.data[i] = lhs.data[i] > rhs.data[i]           ? 
+                                ~typename mask_type::element_type(0) : 
+                                 typename mask_type::element_type(0);
             }
-            return mask_type{result};
+            return result;
         #endif
     }    
 
-    friend mask_type 
+    friend constexpr mask_type 
     operator>(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data > vector_type { rhs } };
+            return mask_type { lhs.data > rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] > rhs                    ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] > rhs                    ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator>(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } > rhs.data };
+            return mask_type { lhs > rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs > rhs.data[i]                    ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs > rhs.data[i]                    ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator<=(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return mask_type { lhs.data <= rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] <= rhs.data[i]           ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] <= rhs.data[i]           ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator<=(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data <= vector_type { rhs } };
+            return mask_type { lhs.data <= rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] <= rhs                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] <= rhs                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator<=(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } <= rhs.data };
+            return mask_type { lhs <= rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs <= rhs.data[i]                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs <= rhs.data[i]                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator>=(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return mask_type { lhs.data >= rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] >= rhs.data[i]           ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] >= rhs.data[i]           ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator>=(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return mask_type { lhs.data >= vector_type { rhs } };
+            return mask_type { lhs.data >= rhs };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] >= rhs                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs.data[i] >= rhs                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }
     
-    friend mask_type 
+    friend constexpr mask_type 
     operator>=(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return mask_type { vector_type { lhs } >= rhs.data };
+            return mask_type { lhs >= rhs.data };
         #else
-            std::array<typename mask_type::element_type, N> result{};
+            mask_type result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs >= rhs.data[i]                   ? 
-                             typename mask_type::element_type(~0) : 
-                             typename mask_type::element_type(0);
+                 result.data[i] = lhs >= rhs.data[i]                   ? 
+                                  typename mask_type::element_type(~0) : 
+                                  typename mask_type::element_type(0);
             }
-            return mask_type(result);
+            return result;
         #endif
     }    
 
@@ -1061,162 +1653,363 @@ public:
     /* Bitwise Operators */
     /*-------------------*/
 
-    friend simd
+    friend constexpr simd
     operator<<(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data << rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] << rhs.data[i];
+                 result.data[i] = lhs.data[i] << rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator<<(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data << vector_type { rhs } };
+            return simd { lhs.data << rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                result[i] = lhs.data[i] << rhs;
+                result.data[i] = lhs.data[i] << rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator<<(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } << rhs.data };
+            return simd { lhs << rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs << rhs.data[i];
+                 result.data[i] = lhs << rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator>>(const simd& lhs, const simd& rhs) {
         #if defined(__clang__)
             return simd { lhs.data >> rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] >> rhs.data[i];
+                 result.data[i] = lhs.data[i] >> rhs.data[i];
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator>>(const simd& lhs, const T& rhs) {
         #if defined(__clang__)
-            return simd { lhs.data >> vector_type { rhs } };
+            return simd { lhs.data >> rhs };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = lhs.data[i] >> rhs;
+                 result.data[i] = lhs.data[i] >> rhs;
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    friend simd 
+    friend constexpr simd 
     operator>>(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
-            return simd { vector_type { lhs } >> rhs.data };
+            return simd { lhs >> rhs.data };
         #else
-                std::array<T, N> result;
+                simd result;
                 for (std::size_t i = 0; i < N; ++i) {
-                     result[i] = lhs >> rhs.data[i];
+                     result.data[i] = lhs >> rhs.data[i];
                 }
-                return simd { result };
+                return result;
         #endif
     }
 
-    /*-------------------*/
-    /* Utility Functions */
-    /*-------------------*/
-
-    constexpr T 
-    horizontal_sum() const {
-        T result = data[0];
-        for (std::size_t i = 1; i < N; ++i) {
-             result += data[i];
-        }
-        return result;
-    }
-
-    constexpr T 
-    horizontal_product() const {
-        T result = data[0];
-        for (std::size_t i = 1; i < N; ++i) {
-             result *= data[i];
-        }
-        return result;
-    }
-
-    /* Dot product of two vectors. */
-    constexpr T 
-    dot_product(const simd& lhs, const simd& rhs) {
-        return (lhs * rhs).horizontal_sum();
-    }
-
-    constexpr simd 
-    incremental_sequence() {
+    /* Lane-wise bitwise operators, for integral lanes only. Floating-point */
+    /* lanes can be reinterpreted with bit_cast first.                      */
+    constexpr simd
+    operator~() const {
         #if defined(__clang__)
+            return simd { ~data };
+        #else
             simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result.data[i] = static_cast<T>(i);
+                 result.data[i] = static_cast<T>(~data[i]);
             }
             return result;
-        #else
-            std::array<T, N> result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator&(const simd& lhs, const simd& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data & rhs.data };
+        #else
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = static_cast<T>(i);
+                 result.data[i] = static_cast<T>(lhs.data[i] & rhs.data[i]);
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    constexpr simd 
-    incremental_sequence_reversed() {
+    friend constexpr simd
+    operator&(const simd& lhs, const T& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data & rhs };
+        #else
+            simd result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = static_cast<T>(lhs.data[i] & rhs);
+            }
+            return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator&(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
+            return simd { lhs & rhs.data };
+        #else
             simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result.data[i] = static_cast<T>(N - 1 - i);
+                 result.data[i] = static_cast<T>(lhs & rhs.data[i]);
             }
             return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator|(const simd& lhs, const simd& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data | rhs.data };
         #else
-            std::array<T, N> result;
+            simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = static_cast<T>(N - 1 - i);
+                 result.data[i] = static_cast<T>(lhs.data[i] | rhs.data[i]);
             }
-            return simd { result };
+            return result;
         #endif
     }
 
-    /* Reverse the order of elements in the vector. */
-    constexpr simd
-    reverse() const {
+    friend constexpr simd
+    operator|(const simd& lhs, const T& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data | rhs };
+        #else
+            simd result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = static_cast<T>(lhs.data[i] | rhs);
+            }
+            return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator|(const T& lhs, const simd& rhs) {
+        #if defined(__clang__)
+            return simd { lhs | rhs.data };
+        #else
+            simd result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = static_cast<T>(lhs | rhs.data[i]);
+            }
+            return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator^(const simd& lhs, const simd& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data ^ rhs.data };
+        #else
+            simd result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = static_cast<T>(lhs.data[i] ^ rhs.data[i]);
+            }
+            return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator^(const simd& lhs, const T& rhs) {
+        #if defined(__clang__)
+            return simd { lhs.data ^ rhs };
+        #else
+            simd result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = static_cast<T>(lhs.data[i] ^ rhs);
+            }
+            return result;
+        #endif
+    }
+
+    friend constexpr simd
+    operator^(const T& lhs, const simd& rhs) {
         #if defined(__clang__)
+            return simd { lhs ^ rhs.data };
+        #else
             simd result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result.data[i] = data[N - 1 - i];
+                 result.data[i] = static_cast<T>(lhs ^ rhs.data[i]);
             }
             return result;
+        #endif
+    }
+
+    constexpr simd&
+    operator&=(const simd& rhs) {
+        #if defined(__clang__)
+            data &= rhs.data;
+        #else
+            for (std::size_t i = 0; i < N; ++i) {
+                 data[i] &= rhs.data[i];
+            }
+        #endif
+        return *this;
+    }
+
+    constexpr simd&
+    operator|=(const simd& rhs) {
+        #if defined(__clang__)
+            data |= rhs.data;
+        #else
+            for (std::size_t i = 0; i < N; ++i) {
+                 data[i] |= rhs.data[i];
+            }
+        #endif
+        return *this;
+    }
+
+    constexpr simd&
+    operator^=(const simd& rhs) {
+        #if defined(__clang__)
+            data ^= rhs.data;
         #else
-            std::array<T, N> result;
             for (std::size_t i = 0; i < N; ++i) {
-                 result[i] = data[N - 1 - i];
+                 data[i] ^= rhs.data[i];
             }
-            return simd { result };
         #endif
+        return *this;
+    }
+
+    /*-------------------*/
+    /* Utility Functions */
+    /*-------------------*/
+
+    /* Sum of all elements. Reduced as a pairwise tree by folding the high  */
+    /* half onto the low half, giving log2(N) vector adds instead of N - 1  */
+    /* dependent scalar adds. The association order is fixed by N, so the   */
+    /* result is deterministic, but may differ from a serial left fold.     */
+    constexpr T 
+    horizontal_sum() const {
+        if constexpr (N == 1) {
+            return data[0];
+        } else if constexpr (N % 2 == 0) {
+            return (get_low<N/2>() + get_high<N/2>()).horizontal_sum();
+        } else {
+            return (get_low<N/2>() + get_high<N/2>()).horizontal_sum() 
+                 + data[N/2];
+        }
+    }
+
+    /* Product of all elements, reduced in the same tree order as the sum. */
+    constexpr T 
+    horizontal_product() const {
+        if constexpr (N == 1) {
+            return data[0];
+        } else if constexpr (N % 2 == 0) {
+            return (get_low<N/2>() * get_high<N/2>()).horizontal_product();
+        } else {
+            return (get_low<N/2>() * get_high<N/2>()).horizontal_product() 
+                 * data[N/2];
+        }
+    }
+
+    /* Smallest element, reduced in the same tree order as the sum. */
+    constexpr T 
+    horizontal_min() const {
+        if constexpr (N == 1) {
+            return data[0];
+        } else {
+            const simd<T, N/2> folded = min(get_low<N/2>(), get_high<N/2>());
+            if constexpr (N % 2 == 0) {
+                return folded.horizontal_min();
+            } else {
+                const T rest = folded.horizontal_min();
+                return data[N/2] < rest ? T(data[N/2]) : rest;
+            }
+        }
+    }
+
+    /* Largest element, reduced in the same tree order as the sum. */
+    constexpr T 
+    horizontal_max() const {
+        if constexpr (N == 1) {
+            return data[0];
+        } else {
+            const simd<T, N/2> folded = max(get_low<N/2>(), get_high<N/2>());
+            if constexpr (N % 2 == 0) {
+                return folded.horizontal_max();
+            } else {
+                const T rest = folded.horizontal_max();
+                return data[N/2] > rest ? T(data[N/2]) : rest;
+            }
+        }
+    }
+
+    /* Dot product of two vectors. The first level of the reduction tree */
+    /* is fused into the multiply, so N/2 products are folded with fma.  */
+    static constexpr T 
+    dot_product(const simd& lhs, const simd& rhs) {
+        if constexpr (N == 1) {
+            return lhs.data[0] * rhs.data[0];
+        } else {
+            const simd<T, N/2> folded = 
+            fma(lhs.template get_low<N/2>(),  rhs.template get_low<N/2>(),
+                lhs.template get_high<N/2>() * rhs.template get_high<N/2>());
+            if constexpr (N % 2 == 0) {
+                return folded.horizontal_sum();
+            } else {
+                return folded.horizontal_sum() + lhs.data[N/2] * rhs.data[N/2];
+            }
+        }
+    }
+
+    /* Lanes 0, 1, ..., N - 1. */
+    static constexpr simd 
+    incremental_sequence() {
+        simd result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = static_cast<T>(i);
+        }
+        return result;
+    }
+
+    /* Lanes N - 1, ..., 1, 0. */
+    static constexpr simd 
+    incremental_sequence_reversed() {
+        simd result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = static_cast<T>(N - 1 - i);
+        }
+        return result;
+    }
+
+    /* Reverse the order of elements in the vector. */
+    constexpr simd
+    reverse() const {
+        simd result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = data[N - 1 - i];
+        }
+        return result;
     }
 
     /* Get low part of the vector. */
@@ -1224,11 +2017,15 @@ public:
     constexpr simd<T, M>
     get_low() const {
         static_assert(M <= N, "Low size must be less than or equal to simd size");
-        simd<T, M> result;
-        for (std::size_t i = 0; i < M; ++i) {
-             result.data[i] = data[i];
-        }
-        return result;
+        #if defined(__clang__)
+            return extract_lanes<0>(std::make_index_sequence<M>{});
+        #else
+            simd<T, M> result;
+            for (std::size_t i = 0; i < M; ++i) {
+                 result.data[i] = data[i];
+            }
+            return result;
+        #endif
     }
 
     /* Get high part of the vector. */
@@ -1236,266 +2033,2286 @@ public:
     constexpr simd<T, M>
     get_high() const {
         static_assert(M <= N, "High size must be less than or equal to simd size");
-        simd<T, M> result;
-        for (std::size_t i = 0; i < M; ++i) {
-             result.data[i] = data[N - M + i];
+        #if defined(__clang__)
+            return extract_lanes<N - M>(std::make_index_sequence<M>{});
+        #else
+            simd<T, M> result;
+            for (std::size_t i = 0; i < M; ++i) {
+                 result.data[i] = data[N - M + i];
+            }
+            return result;
+        #endif
+    }
+
+private:
+
+    #if defined(__clang__)
+        /* Extract lanes [Offset, Offset + M) as a single shuffle. */
+        template<std::size_t Offset, std::size_t... I>
+        constexpr simd<T, sizeof...(I)>
+        extract_lanes(std::index_sequence<I...>) const {
+            using result_type = simd<T, sizeof...(I)>;
+            return result_type { typename result_type::vector_type (
+                   __builtin_shufflevector(data, data, (Offset + I)...)) };
         }
-        return result;
+    #endif
+
+};
+
+/*--------------*/
+/* Native Width */
+/*--------------*/
+
+/* Lanes of T that fill the widest vector register of the compile target, */
+/* from SF_ISA_VECTOR_BYTES: 16 for float on AVX-512, 8 on AVX, and 4 on   */
+/* SSE2 or NEON. Use it instead of hard-coding N so a rebuild for another */
+/* target picks up the wider registers; to choose at run time from a      */
+/* single binary, see scl_dispatch.hpp.                                   */
+template<typename T>
+inline constexpr std::size_t native_width = 
+SF_ISA_VECTOR_BYTES / sizeof(T) > 0 ? SF_ISA_VECTOR_BYTES / sizeof(T) : 1;
+
+/* simd vector of native_width<T> lanes. */
+template<typename T>
+using simd_native = simd<T, native_width<T>>;
+
+/*-------------------*/
+/* Memory Management */
+/*-------------------*/
+
+/* Allocator for standard containers that aligns every allocation to Align  */
+/* bytes, e.g. std::vector<float, aligned_allocator<float>> for buffers that */
+/* are accessed with load_aligned, store_aligned, and stream.                */
+template<typename T, std::size_t Align = 64>
+class aligned_allocator {
+public:
+
+    static_assert((Align & (Align - 1)) == 0, 
+                  "aligned_allocator<T, Align> requires a power-of-two Align");
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    /* Alignment actually requested from operator new. */
+    static constexpr std::size_t alignment = 
+    Align > alignof(T) ? Align : alignof(T);
+
+public:
+
+    aligned_allocator() = default;
+
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    T* 
+    allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(
+               ::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    void 
+    deallocate(T* ptr, std::size_t n) noexcept {
+        ::operator delete(ptr, n * sizeof(T), std::align_val_t(alignment));
+    }
+
+    template<typename U>
+    friend bool 
+    operator==(const aligned_allocator&, 
+               const aligned_allocator<U, Align>&) noexcept {
+        return true;
     }
 
 };
 
-/*-------------------------------------------------*/
-/* Selection, Blending, Permutation, and Swizzling */
-/*-------------------------------------------------*/
+/* Order preceding stream() stores before any later stores. */
+sf_inline void
+stream_fence() {
+    #if defined(SF_ISA_SSE2)
+        _mm_sfence();
+    #else
+        std::atomic_thread_fence(std::memory_order_release);
+    #endif
+}
 
-/* Cut off vector to n elements. The last elements are set to zero. */
-template<typename T, std::size_t N>
+/*---------------------*/
+/* Gather and Scatter  */
+/*---------------------*/
+
+/* Load base[index[i]] into lane i. Signed 32-bit indices into 32-bit     */
+/* elements and signed 64-bit indices into 64-bit elements use the native */
+/* AVX2/AVX-512 gathers; every other combination is an unrolled loop of   */
+/* indexed loads, which the autovectorizer turns into SVE/RVV gathers.    */
+template<typename T, typename I, std::size_t N>
 constexpr sf_inline simd<T, N>
-cutoff(const simd<T, N>& vector, std::size_t n) {
+gather(const T* base, const simd<I, N>& index) {
+    static_assert(std::is_integral<I>::value, "gather requires integral indices");
+
+    constexpr bool native32 = sizeof(T) == 4 && sizeof(I) == 4 && 
+                              std::is_signed<I>::value;
+    constexpr bool native64 = sizeof(T) == 8 && sizeof(I) == 8 && 
+                              std::is_signed<I>::value;
+    sf_unused_parameter(native32);
+    sf_unused_parameter(native64);
+
+    simd<T, N> result;
+    #if defined(SF_ISA_AVX512F)
+    /* Full-mask forms; the unmasked intrinsics trip -Wuninitialized on GCC. */
+    if constexpr (native32 && N == 16) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 
+                                                  __mmask16(0xFFFF), 
+                                                  std::bit_cast<__m512i>(index.data), 
+                                                  base, 4));
+    } else if constexpr (native64 && N == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 
+                                                  __mmask8(0xFF), 
+                                                  std::bit_cast<__m512i>(index.data), 
+                                                  base, 8));
+    } else
+    #endif
+    #if defined(SF_ISA_AVX2)
+    if constexpr (native32 && N == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), 
+                                             std::bit_cast<__m256i>(index.data), 
+                                             4));
+    } else if constexpr (native64 && N == 4) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_i64gather_epi64(reinterpret_cast<const long long*>(base), 
+                                             std::bit_cast<__m256i>(index.data), 
+                                             8));
+    } else
+    #endif
+    {
+        scl_profile_count(gather_loop);
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = base[index.data[i]];
+        }
+    }
+    return result;
+}
+
+/* Load base[index[i]] into each lane whose mask is set; inactive lanes */
+/* take the value from src and their addresses are never read.          */
+template<typename T, typename I, std::size_t N>
+constexpr sf_inline simd<T, N>
+masked_gather(const typename simd<T, N>::mask_type& mask, 
+              const T*                               base, 
+              const simd<I, N>&                      index, 
+              const simd<T, N>&                      src) {
+    static_assert(std::is_integral<I>::value, "gather requires integral indices");
+    scl_profile_lanes(masked_gather, profile::active_lanes(mask, N), N);
+
+    constexpr bool native32 = sizeof(T) == 4 && sizeof(I) == 4 && 
+                              std::is_signed<I>::value;
+    sf_unused_parameter(native32);
+
+    simd<T, N> result;
+    #if defined(SF_ISA_AVX512F)
+    if constexpr (native32 && N == 16) {
+        const __m512i bits = std::bit_cast<__m512i>(mask.data);
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_mask_i32gather_epi32(std::bit_cast<__m512i>(src.data), 
+                                                  _mm512_test_epi32_mask(bits, bits), 
+                                                  std::bit_cast<__m512i>(index.data), 
+                                                  base, 4));
+    } else
+    #endif
+    #if defined(SF_ISA_AVX2)
+    if constexpr (native32 && N == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_mask_i32gather_epi32(std::bit_cast<__m256i>(src.data), 
+                                                  reinterpret_cast<const int*>(base), 
+                                                  std::bit_cast<__m256i>(index.data), 
+                                                  std::bit_cast<__m256i>(mask.data), 
+                                                  4));
+    } else
+    #endif
+    {
+        scl_profile_count(gather_loop);
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = mask.data[i] ? base[index.data[i]] : src.data[i];
+        }
+    }
+    return result;
+}
+
+/* Store lane i to base[index[i]]. Lanes are written in ascending order, */
+/* so when indices repeat the highest lane wins. AVX-512 uses the native */
+/* scatters for the same index/element pairs as gather.                  */
+template<typename T, typename I, std::size_t N>
+constexpr sf_inline void
+scatter(T* base, const simd<I, N>& index, const simd<T, N>& value) {
+    static_assert(std::is_integral<I>::value, "scatter requires integral indices");
+
+    constexpr bool native32 = sizeof(T) == 4 && sizeof(I) == 4 && 
+                              std::is_signed<I>::value;
+    constexpr bool native64 = sizeof(T) == 8 && sizeof(I) == 8 && 
+                              std::is_signed<I>::value;
+    sf_unused_parameter(native32);
+    sf_unused_parameter(native64);
+
+    #if defined(SF_ISA_AVX512F)
+    if constexpr (native32 && N == 16) {
+        _mm512_i32scatter_epi32(base, std::bit_cast<__m512i>(index.data), 
+                                std::bit_cast<__m512i>(value.data), 4);
+    } else if constexpr (native64 && N == 8) {
+        _mm512_i64scatter_epi64(base, std::bit_cast<__m512i>(index.data), 
+                                std::bit_cast<__m512i>(value.data), 8);
+    } else
+    #endif
+    {
+        scl_profile_count(scatter_loop);
+        for (std::size_t i = 0; i < N; ++i) {
+             base[index.data[i]] = value.data[i];
+        }
+    }
+}
+
+/* Store lanes whose mask is set to base[index[i]]; others are skipped. */
+template<typename T, typename I, std::size_t N>
+constexpr sf_inline void
+masked_scatter(const typename simd<T, N>::mask_type& mask, 
+               T*                                     base, 
+               const simd<I, N>&                      index, 
+               const simd<T, N>&                      value) {
+    static_assert(std::is_integral<I>::value, "scatter requires integral indices");
+    scl_profile_lanes(masked_scatter, profile::active_lanes(mask, N), N);
+
+    constexpr bool native32 = sizeof(T) == 4 && sizeof(I) == 4 && 
+                              std::is_signed<I>::value;
+    sf_unused_parameter(native32);
+
+    #if defined(SF_ISA_AVX512F)
+    if constexpr (native32 && N == 16) {
+        const __m512i bits = std::bit_cast<__m512i>(mask.data);
+        _mm512_mask_i32scatter_epi32(base, _mm512_test_epi32_mask(bits, bits), 
+                                     std::bit_cast<__m512i>(index.data), 
+                                     std::bit_cast<__m512i>(value.data), 4);
+    } else
+    #endif
+    {
+        scl_profile_count(scatter_loop);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (mask.data[i]) base[index.data[i]] = value.data[i];
+        }
+    }
+}
+
+/*---------------------------*/
+/* Interleaved Memory Access */
+/*---------------------------*/
+
+/* Load K * N elements stored as N interleaved K-tuples, e.g. xyzxyz... or */
+/* rgbargba..., and return field k of every tuple in vector k:            */
+/*                                                                        */
+/*     auto [x, y, z] = load_interleaved<3>(vertices);                    */
+/*                                                                        */
+/* On Clang this is one wide load and K strided shuffles, which LLVM      */
+/* lowers to vld2/vld3/vld4 on NEON and to shuffle networks on x86. The   */
+/* fallback unrolls the field loop so GCC forms the same shuffle network. */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline std::array<simd<T, N>, K>
+load_interleaved(const T* ptr) {
+    static_assert(K > 1, "load_interleaved requires at least two fields");
+    std::array<simd<T, N>, K> result;
     #if defined(__clang__)
-        simd<T, N> result;
+        using wide_type   = T __attribute__((ext_vector_type(K * N)));
+        using vector_type = typename simd<T, N>::vector_type;
+        wide_type wide;
+        std::memcpy(&wide, ptr, sizeof(T) * K * N);
+        [&]<std::size_t... F>(std::index_sequence<F...>) {
+            const auto field = [&]<std::size_t... I>(auto f, std::index_sequence<I...>) {
+                return vector_type(__builtin_shufflevector(wide, wide, 
+                                                           (I * K + f())...));
+            };
+            ((result[F].data = field(std::integral_constant<std::size_t, F>{}, 
+                                     std::make_index_sequence<N>{})), ...);
+        }(std::make_index_sequence<K>{});
+    #else
         for (std::size_t i = 0; i < N; ++i) {
-             result.data[i] = (i < n) ? vector.data[i] : T(0);
+            sf_unroll(16)
+            for (std::size_t k = 0; k < K; ++k) {
+                 result[k].data[i] = ptr[i * K + k];
+            }
         }
-        return result;
+    #endif
+    return result;
+}
+
+/* Store K vectors as N interleaved K-tuples, the inverse of load_interleaved. */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline void
+store_interleaved(T* ptr, const std::array<simd<T, N>, K>& fields) {
+    static_assert(K > 1, "store_interleaved requires at least two fields");
+    #if defined(__clang__)
+        using wide_type = T __attribute__((ext_vector_type(K * N)));
+        wide_type wide;
+        for (std::size_t k = 0; k < K; ++k) {
+             std::memcpy(reinterpret_cast<char*>(&wide) + k * N * sizeof(T), 
+                         &fields[k].data, sizeof(T) * N);
+        }
+        [&]<std::size_t... J>(std::index_sequence<J...>) {
+            const wide_type tuples = __builtin_shufflevector(wide, wide, 
+                                                             ((J % K) * N + J / K)...);
+            std::memcpy(ptr, &tuples, sizeof(T) * K * N);
+        }(std::make_index_sequence<K * N>{});
     #else
-        std::array<T, N> result;
         for (std::size_t i = 0; i < N; ++i) {
-             result[i] = (i < n) ? vector.data[i] : T(0);
+            sf_unroll(16)
+            for (std::size_t k = 0; k < K; ++k) {
+                 ptr[i * K + k] = fields[k].data[i];
+            }
         }
-        return simd<T, N> { result };
     #endif
 }
 
-/* Select between two simd vectors, element by element, based on mask */
-template<typename T, std::size_t N>
-constexpr sf_inline simd<T, N>
-select(const typename simd<T, N>::mask_type& mask, 
-       const          simd<T, N>&            a, 
-       const          simd<T, N>&            b) {
-    #if defined(__clang__)
-        simd<T, N> result;
-        for (std::size_t i = 0; i < N; ++i) {
-             result.data[i] = mask.data[i] ? a.data[i] : b.data[i];
-        }
-        return result;
-    #else
-        std::array<T, N> result;
-        for (std::size_t i = 0; i < N; ++i) {
-             result[i] = mask.data[i] ? a.data[i] : b.data[i];
+/* Store the given vectors as interleaved tuples: store_interleaved(p, x, y, z). */
+template<typename T, std::size_t N, typename... Rest>
+constexpr sf_inline void
+store_interleaved(T* ptr, const simd<T, N>& first, const Rest&... rest) {
+    store_interleaved<1 + sizeof...(Rest), T, N>(
+        ptr, std::array<simd<T, N>, 1 + sizeof...(Rest)> { first, rest... });
+}
+
+/*-------------------------------------------------*/
+/* Selection, Blending, Permutation, and Swizzling */
+/*-------------------------------------------------*/
+
+/* Cut off vector to n elements. The last elements are set to zero. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+cutoff(const simd<T, N>& vector, std::size_t n) {
+    simd<T, N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = (i < n) ? vector.data[i] : T(0);
+    }
+    return result;
+}
+
+namespace detail {
+
+/* Unsigned integer the size of a lane, for bitwise selection. */
+template<std::size_t Bytes> struct lane_bits;
+template<> struct lane_bits<1> { using type = std::uint8_t;  };
+template<> struct lane_bits<2> { using type = std::uint16_t; };
+template<> struct lane_bits<4> { using type = std::uint32_t; };
+template<> struct lane_bits<8> { using type = std::uint64_t; };
+
+} /* namespace detail */
+
+/* Select between two simd vectors, element by element, based on mask */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+select(const typename simd<T, N>::mask_type& mask, 
+       const          simd<T, N>&            a, 
+       const          simd<T, N>&            b) {
+    simd<T, N> result;
+    #if !defined(__clang__)
+    /* GCC turns the ternary into a branch per lane without SSE4.1, and */
+    /* into masked loads with AVX2; as a bitwise blend of the lane bits */
+    /* it is pand/pandn/por or one blendv.                              */
+    if constexpr (sizeof(T) <= 8 && std::has_single_bit(sizeof(T))) {
+        using U = typename detail::lane_bits<sizeof(T)>::type;
+        sf_unroll(64)
+        for (std::size_t i = 0; i < N; ++i) {
+             const U m = mask.data[i] ? U(~U(0)) : U(0);
+             result.data[i] = std::bit_cast<T>(U((std::bit_cast<U>(a.data[i]) &  m) | 
+                                                 (std::bit_cast<U>(b.data[i]) & ~m)));
+        }
+        return result;
+    }
+    #endif
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = mask.data[i] ? a.data[i] : b.data[i];
+    }
+    return result;
+}
+
+/* Blend two vectors according to immediate constant mask */
+template<std::size_t... I, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+blend(const simd<T, N>& a, const simd<T, N>& b) {
+    constexpr bool mask[N] = { ((I < N) ? true : false)... };
+    #if defined(__clang__)
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = mask[i] ? a.data[i] : b.data[i];
+        }
+        return result;
+    #else
+        /* Expanded per lane as in permute; GCC keeps the loop and reads */
+        /* the mask from the stack at run time.                          */
+        return [&]<std::size_t... J>(std::index_sequence<J...>) {
+            return simd<T, N> { 
+                std::array<T, N> { (mask[J] ? a.data[J] : b.data[J])... } 
+            };
+        }(std::make_index_sequence<N>{});
+    #endif
+}
+
+/* Permute elements in simd vector according to immediate indices */
+template<std::size_t... I, typename T, std::size_t N>
+constexpr sf_inline simd<T, sizeof...(I)>
+permute(const simd<T, N>& vector) {
+    static_assert(sizeof...(I) <= N, "Too many indices for simd vector size");
+    
+    #if defined(__clang__)
+        using result_type = simd<T, sizeof...(I)>;
+        typename result_type::vector_type result;
+        constexpr std::size_t indices[] = { I... };
+        for (std::size_t i = 0; i < sizeof...(I); ++i) {
+             result[i] = vector.data[indices[i]];
+        }
+        return result_type { result };
+    #else
+        /* Expanded per lane rather than looped over an index table, which */
+        /* GCC would otherwise vectorize as a gather from the stack.        */
+        return simd<T, sizeof...(I)> { 
+            std::array<T, sizeof...(I)> { vector.data[I]... } 
+        };
+    #endif
+}
+
+/* Shuffle elements from two vectors according to immediate indices */
+template<std::size_t... I, typename T, std::size_t N>
+constexpr sf_inline simd<T, sizeof...(I)>
+shuffle(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(sizeof...(I) <= 2*N, 
+                  "Too many indices for simd vector size");
+    
+    #if defined(__clang__)
+        using result_type = simd<T, sizeof...(I)>;
+        typename result_type::vector_type result;
+        constexpr std::size_t indices[] = { I... };
+        for (std::size_t i = 0; i < sizeof...(I); ++i) {
+            if (indices[i] < N) {
+                result[i] = a.data[indices[i]];
+            } else {
+                result[i] = b.data[indices[i] - N];
+            }
+        }
+        return result_type{result};
+    #else
+        /* Expanded per lane, as in permute; I % N is I - N for lanes of b. */
+        return simd<T, sizeof...(I)> { 
+            std::array<T, sizeof...(I)> { (I < N ? a.data[I % N] : b.data[I % N])... } 
+        };
+    #endif
+}
+
+namespace detail {
+
+/* Register-sized piece of a vector's storage, by byte offset. */
+template<typename V>
+sf_inline V
+load_chunk(const void* base, std::size_t offset) {
+    V v;
+    std::memcpy(&v, static_cast<const unsigned char*>(base) + offset, sizeof(V));
+    return v;
+}
+
+template<typename V>
+sf_inline void
+store_chunk(void* base, std::size_t offset, const V& v) {
+    std::memcpy(static_cast<unsigned char*>(base) + offset, &v, sizeof(V));
+}
+
+/* Scalar lookup, for shapes without a shuffle instruction and for */
+/* constant evaluation.                                            */
+template<typename T, std::size_t M, typename I, std::size_t N>
+constexpr sf_inline simd<T, N>
+lookup_lanes(const simd<T, M>& table, const simd<I, N>& index) {
+    using U = typename std::make_unsigned<I>::type;
+    scl_profile_count(lookup_loop);
+    simd<T, N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = table.data[std::size_t(U(index.data[i])) % M];
+    }
+    return result;
+}
+
+} /* namespace detail */
+
+/* Table lookup with runtime indices: lane i of the result is             */
+/* table[index[i] % M]. Byte tables of 16 entries map to pshufb (SSSE3)   */
+/* or NEON tbl for any multiple of 16 indices; 32- and 64-entry byte      */
+/* tables use AVX-512 VBMI vpermb, AVX2 pairs of vpshufb, or tbl2/tbl4;  */
+/* 16-, 32- and 64-bit tables whose size matches the index count use     */
+/* vpermw, vpermd and vpermq. Other shapes fall back to a scalar loop.   */
+template<typename T, std::size_t M, typename I, std::size_t N>
+constexpr sf_inline simd<T, N>
+lookup(const simd<T, M>& table, const simd<I, N>& index) {
+    static_assert(std::is_integral<I>::value, "lookup requires integral indices");
+    if (std::is_constant_evaluated()) {
+        return detail::lookup_lanes(table, index);
+    }
+
+    [[maybe_unused]] constexpr bool bytes  = sizeof(T) == 1 && sizeof(I) == 1;
+    [[maybe_unused]] constexpr bool words  = sizeof(T) == 2 && sizeof(I) == 2;
+    [[maybe_unused]] constexpr bool dwords = sizeof(T) == 4 && sizeof(I) == 4;
+    [[maybe_unused]] constexpr bool qwords = sizeof(T) == 8 && sizeof(I) == 8;
+
+    /* AVX-512 paths use full-mask forms; the unmasked intrinsics trip */
+    /* -Wuninitialized on GCC.                                         */
+    simd<T, N> result;
+    sf_unused_parameter(result);
+    #if defined(SF_ISA_SSE2) && defined(__SSSE3__)
+    if constexpr (bytes && M == 16 && N % 16 == 0) {
+        /* 64-byte steps only on Clang; see movemask_chunk for why. */
+        #if defined(SF_ISA_AVX512F) && defined(__AVX512BW__) && defined(__clang__)
+            constexpr std::size_t step = N % 64 == 0 ? 64 : N % 32 == 0 ? 32 : 16;
+        #elif defined(SF_ISA_AVX2)
+            constexpr std::size_t step = N % 32 == 0 ? 32 : 16;
+        #else
+            constexpr std::size_t step = 16;
+        #endif
+        const __m128i t = detail::load_chunk<__m128i>(&table.data, 0);
+        for (std::size_t c = 0; c < N; c += step) {
+            #if defined(SF_ISA_AVX512F) && defined(__AVX512BW__)
+            if constexpr (step == 64) {
+                const __m512i i = detail::load_chunk<__m512i>(&index.data, c);
+                detail::store_chunk(&result.data, c, 
+                    _mm512_shuffle_epi8(_mm512_maskz_broadcast_i32x4(__mmask16(0xFFFF), t), 
+                                        _mm512_and_si512(i, _mm512_set1_epi8(0x0F))));
+                continue;
+            }
+            #endif
+            #if defined(SF_ISA_AVX2)
+            if constexpr (step == 32) {
+                const __m256i i = detail::load_chunk<__m256i>(&index.data, c);
+                detail::store_chunk(&result.data, c, 
+                    _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(t), 
+                                        _mm256_and_si256(i, _mm256_set1_epi8(0x0F))));
+                continue;
+            }
+            #endif
+            const __m128i i = detail::load_chunk<__m128i>(&index.data, c);
+            detail::store_chunk(&result.data, c, 
+                _mm_shuffle_epi8(t, _mm_and_si128(i, _mm_set1_epi8(0x0F))));
+        }
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_AVX512F) && defined(__AVX512VBMI__)
+    if constexpr (bytes && M == 64 && N % 64 == 0) {
+        const __m512i t = detail::load_chunk<__m512i>(&table.data, 0);
+        for (std::size_t c = 0; c < N; c += 64) {
+             detail::store_chunk(&result.data, c, 
+                 _mm512_maskz_permutexvar_epi8(__mmask64(~0ull), 
+                     detail::load_chunk<__m512i>(&index.data, c), t));
+        }
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_AVX512F) && defined(__AVX512VBMI__) && defined(__AVX512VL__)
+    if constexpr (bytes && M == 32 && N % 32 == 0) {
+        const __m256i t = detail::load_chunk<__m256i>(&table.data, 0);
+        for (std::size_t c = 0; c < N; c += 32) {
+             detail::store_chunk(&result.data, c, 
+                 _mm256_maskz_permutexvar_epi8(__mmask32(~0u), 
+                     detail::load_chunk<__m256i>(&index.data, c), t));
+        }
+        return result;
+    }
+    #elif defined(SF_ISA_AVX2)
+    if constexpr (bytes && M == 32 && N % 32 == 0) {
+        /* vpshufb only indexes within a 128-bit lane, so look up in both */
+        /* halves of the table and pick by bit 4 of the index.            */
+        const __m256i t  = detail::load_chunk<__m256i>(&table.data, 0);
+        const __m256i lo = _mm256_permute2x128_si256(t, t, 0x00);
+        const __m256i hi = _mm256_permute2x128_si256(t, t, 0x11);
+        for (std::size_t c = 0; c < N; c += 32) {
+            const __m256i i = _mm256_and_si256(detail::load_chunk<__m256i>(&index.data, c),
+                                               _mm256_set1_epi8(0x1F));
+            detail::store_chunk(&result.data, c, 
+                _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, i), 
+                                   _mm256_shuffle_epi8(hi, i), 
+                                   _mm256_slli_epi16(i, 3)));
+        }
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_AVX512F) && defined(__AVX512BW__)
+    if constexpr (words && M == 32 && N == 32) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_permutexvar_epi16(__mmask32(~0u), 
+                                                     std::bit_cast<__m512i>(index.data), 
+                                                     std::bit_cast<__m512i>(table.data)));
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_AVX512F)
+    if constexpr (dwords && M == 16 && N == 16) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_permutexvar_epi32(__mmask16(0xFFFF), 
+                                                     std::bit_cast<__m512i>(index.data), 
+                                                     std::bit_cast<__m512i>(table.data)));
+        return result;
+    } else if constexpr (qwords && M == 8 && N == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_permutexvar_epi64(__mmask8(0xFF), 
+                                                     std::bit_cast<__m512i>(index.data), 
+                                                     std::bit_cast<__m512i>(table.data)));
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_AVX2)
+    if constexpr (dwords && M == 8 && N == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_permutevar8x32_epi32(std::bit_cast<__m256i>(table.data), 
+                                                  std::bit_cast<__m256i>(index.data)));
+        return result;
+    }
+    #endif
+    #if defined(SF_ISA_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    if constexpr (bytes && (M == 16 || M == 32 || M == 64) && N % 16 == 0) {
+        /* tbl returns zero for out-of-range indices, so wrap them first. */
+        const uint8x16_t wrap = vdupq_n_u8(std::uint8_t(M - 1));
+        uint8x16x4_t     t;
+        for (std::size_t k = 0; k < M / 16; ++k) {
+             t.val[k] = detail::load_chunk<uint8x16_t>(&table.data, 16 * k);
+        }
+        for (std::size_t c = 0; c < N; c += 16) {
+            const uint8x16_t i = vandq_u8(detail::load_chunk<uint8x16_t>(&index.data, c), wrap);
+            if constexpr (M == 16) {
+                detail::store_chunk(&result.data, c, vqtbl1q_u8(t.val[0], i));
+            } else if constexpr (M == 32) {
+                detail::store_chunk(&result.data, c, 
+                    vqtbl2q_u8(uint8x16x2_t { { t.val[0], t.val[1] } }, i));
+            } else {
+                detail::store_chunk(&result.data, c, vqtbl4q_u8(t, i));
+            }
+        }
+        return result;
+    }
+    #endif
+    return detail::lookup_lanes(table, index);
+}
+
+/* Permute with runtime indices: lane i of the result is v[index[i] % N]. */
+/* This is lookup with v as the table; see there for the instructions.    */
+template<typename T, typename I, std::size_t N>
+constexpr sf_inline simd<T, N>
+permute(const simd<T, N>& v, const simd<I, N>& index) {
+    return lookup(v, index);
+}
+
+/* Swap two simd vectors */
+template<typename T, std::size_t N>
+constexpr sf_inline void
+swap(simd<T, N>& a, simd<T, N>& b) {
+    simd<T, N> temp = a;
+               a    = b;
+               b    = temp;
+}
+
+/* Sign combine two simd vectors */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+sign_combine(const simd<T, N>& a, const simd<T, N>& b) {
+    #if defined(__clang__)
+        return simd<T, N> { a.data ^ 
+                           (b.data & (T(1) << (sizeof(T) * 8 - 1))) };
+    #else
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = a.data[i] ^ 
+                             (b.data[i] & (T(1) << (sizeof(T) * 8 - 1)));
+        }
+        return result;
+    #endif
+}
+
+/* Split simd vector into two simd vectors. */
+template<typename T, std::size_t N>
+constexpr sf_inline std::pair<simd<T, N/2>, simd<T, N/2>>
+split(const simd<T, N>& vector) {
+    static_assert(N % 2 == 0, "Split size must be even");
+    #if defined(__clang__)
+        simd<T, N/2> a;
+        simd<T, N/2> b;
+        for (std::size_t i = 0; i < N/2; ++i) {
+             a.data[i] = vector.data[i];
+             b.data[i] = vector.data[N/2 + i];
+        }
+        return std::make_pair(a, b);
+    #else
+        /* Whole-register copies; GCC builds each half lane by lane from */
+        /* an element loop.                                              */
+        simd<T, N/2> a;
+        simd<T, N/2> b;
+        a.load(vector.data.data());
+        b.load(vector.data.data() + N/2);
+        return std::make_pair(a, b);
+    #endif
+}
+
+/* Merge two simd vectors into one simd vector. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, 2*N>
+merge(const simd<T, N>& a, const simd<T, N>& b) {
+    #if defined(__clang__)
+        simd<T, 2*N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = a.data[i];
+             result.data[N + i] = b.data[i];
+        }
+        return result;
+    #else
+        std::array<T, 2*N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result[i] = a.data[i];
+             result[N + i] = b.data[i];
+        }
+        return simd<T, 2*N> { result };
+    #endif
+}
+
+/*-----------------------------*/
+/* Lane Shifts and Prefix Sums */
+/*-----------------------------*/
+
+namespace detail {
+
+/* Bytes Shift to Shift + R of the register pair hi:lo, lo in the low half, */
+/* for 0 < Shift < R, as palignr does for one 16-byte register.             */
+#if defined(SF_ISA_SSE2)
+template<std::size_t Shift>
+sf_inline __m128i
+alignr_chunk(__m128i hi, __m128i lo) {
+    #if defined(__SSSE3__)
+        return _mm_alignr_epi8(hi, lo, Shift);
+    #else
+        return _mm_or_si128(_mm_srli_si128(lo, Shift), _mm_slli_si128(hi, 16 - Shift));
+    #endif
+}
+#endif
+
+#if defined(SF_ISA_AVX2)
+template<std::size_t Shift>
+sf_inline __m256i
+alignr_chunk(__m256i hi, __m256i lo) {
+    /* vpalignr shifts within 128-bit lanes, so pair each lane with the  */
+    /* one after it: mid holds the high lane of lo and the low lane of hi. */
+    const __m256i mid = _mm256_permute2x128_si256(lo, hi, 0x21);
+    if constexpr (Shift == 16) {
+        return mid;
+    } else if constexpr (Shift < 16) {
+        return _mm256_alignr_epi8(mid, lo, Shift);
+    } else {
+        return _mm256_alignr_epi8(hi, mid, Shift - 16);
+    }
+}
+#endif
+
+#if defined(SF_ISA_AVX512F) && defined(__AVX512BW__)
+template<std::size_t Shift>
+sf_inline __m512i
+alignr_chunk(__m512i hi, __m512i lo) {
+    if constexpr (Shift % 4 == 0) {
+        return _mm512_alignr_epi32(hi, lo, Shift / 4);
+    } else {
+        /* As on AVX2: whole 16-byte lanes first, then vpalignr per lane. */
+        constexpr std::size_t lanes = Shift / 16;
+        const __m512i low  = lanes == 0 ? lo : _mm512_alignr_epi32(hi, lo, (lanes * 4) % 16);
+        const __m512i high = lanes == 3 ? hi : _mm512_alignr_epi32(hi, lo, (lanes * 4 + 4) % 16);
+        return _mm512_alignr_epi8(high, low, Shift % 16);
+    }
+}
+#endif
+
+#if defined(SF_ISA_NEON)
+template<std::size_t Shift>
+sf_inline uint8x16_t
+alignr_chunk(uint8x16_t hi, uint8x16_t lo) {
+    return vextq_u8(lo, hi, Shift);
+}
+#endif
+
+/* Vector register type alignr_chunk takes for a register of R bytes. */
+template<std::size_t R>
+struct alignr_register_type;
+
+#if defined(SF_ISA_SSE2)
+template<>
+struct alignr_register_type<16> { using type = __m128i; };
+#elif defined(SF_ISA_NEON)
+template<>
+struct alignr_register_type<16> { using type = uint8x16_t; };
+#endif
+
+#if defined(SF_ISA_AVX2)
+template<>
+struct alignr_register_type<32> { using type = __m256i; };
+#endif
+
+#if defined(SF_ISA_AVX512F) && defined(__AVX512BW__)
+template<>
+struct alignr_register_type<64> { using type = __m512i; };
+#endif
+
+/* Register alignr works in for a vector of the given bytes, or 0 for the */
+/* scalar loop. 64-byte registers are used on Clang only, as for lookup.  */
+template<std::size_t Bytes>
+inline constexpr std::size_t alignr_register =
+#if defined(SF_ISA_AVX512F) && defined(__AVX512BW__) && defined(__clang__)
+    Bytes % 64 == 0 ? 64 :
+#endif
+#if defined(SF_ISA_AVX2)
+    Bytes % 32 == 0 ? 32 :
+#endif
+#if defined(SF_ISA_SSE2) || defined(SF_ISA_NEON)
+    Bytes % 16 == 0 ? 16 :
+#endif
+    0;
+
+} /* namespace detail */
+
+/* Lanes K to K + N - 1 of the 2N-lane concatenation of lo and hi, lo */
+/* first, so lane i is lo[i + K] for i + K < N and hi[i + K - N]      */
+/* otherwise. This is palignr generalised to any vector width: each   */
+/* register of the result is one palignr (SSSE3) or vext (NEON), plus */
+/* a vperm2i128 on AVX2 where lanes cross the 128-bit halves.         */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+alignr(const simd<T, N>& hi, const simd<T, N>& lo) {
+    static_assert(K <= N, "alignr shift must not exceed the vector size");
+    if constexpr (K == 0) {
+        return lo;
+    } else if constexpr (K == N) {
+        return hi;
+    } else {
+        constexpr std::size_t bytes = sizeof(T) * N;
+        constexpr std::size_t R     = detail::alignr_register<bytes>;
+        if constexpr (R != 0) {
+            if (!std::is_constant_evaluated()) {
+                using register_type = typename detail::alignr_register_type<R>::type;
+
+                /* Result register c starts Shift bytes into register */
+                /* first + c of the concatenation.                    */
+                constexpr std::size_t M     = bytes / R;
+                constexpr std::size_t first = K * sizeof(T) / R;
+                constexpr std::size_t Shift = K * sizeof(T) % R;
+                const auto part = [&](std::size_t q) {
+                    return q < M ? detail::load_chunk<register_type>(&lo.data, q * R)
+                                 : detail::load_chunk<register_type>(&hi.data, (q - M) * R);
+                };
+                simd<T, N> result;
+                for (std::size_t c = 0; c < M; ++c) {
+                    if constexpr (Shift == 0) {
+                        detail::store_chunk(&result.data, c * R, part(first + c));
+                    } else {
+                        detail::store_chunk(&result.data, c * R,
+                            detail::alignr_chunk<Shift>(part(first + c + 1), part(first + c)));
+                    }
+                }
+                return result;
+            }
+        }
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = i + K < N ? lo.data[i + K] : hi.data[i + K - N];
+        }
+        return result;
+    }
+}
+
+/* Move every lane K places up, toward higher indices: lane i is       */
+/* v[i - K], and lanes below K are taken from the top of below, zero   */
+/* by default. slide_up<1>(x, previous) is the vector of x[i - 1] for a */
+/* stream processed N elements at a time.                              */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+slide_up(const simd<T, N>& v, const simd<T, N>& below = simd<T, N>(T(0))) {
+    static_assert(K <= N, "slide_up shift must not exceed the vector size");
+    return alignr<N - K>(v, below);
+}
+
+/* Move every lane K places down: lane i is v[i + K], and lanes from */
+/* N - K up are taken from the bottom of above, zero by default.     */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+slide_down(const simd<T, N>& v, const simd<T, N>& above = simd<T, N>(T(0))) {
+    static_assert(K <= N, "slide_down shift must not exceed the vector size");
+    return alignr<K>(above, v);
+}
+
+namespace detail {
+
+template<std::size_t S, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+prefix_sum_step(const simd<T, N>& v) {
+    if constexpr (S >= N) {
+        return v;
+    } else {
+        return prefix_sum_step<2 * S>(v + slide_up<S>(v));
+    }
+}
+
+} /* namespace detail */
+
+/* Inclusive prefix sum across lanes: lane i is v[0] + ... + v[i]. The */
+/* log2(N) steps each add the vector slid up by 1, 2, 4, ... lanes, so */
+/* floating-point sums are associated differently from a running sum.  */
+/* Add the broadcast last lane of one block to the next to scan a run  */
+/* of blocks, e.g. for delta decoding.                                 */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+prefix_sum(const simd<T, N>& v) {
+    return detail::prefix_sum_step<1>(v);
+}
+
+/*----------------------*/
+/* Arithmetic Functions */
+/*----------------------*/
+
+/* Computes a * b + c. For floating-point lanes this is a single rounding */
+/* when the target has hardware FMA (SF_ISA_FMA); otherwise it falls back */
+/* to a separate multiply and add rather than a slow software fma. Half-  */
+/* precision lanes always take the latter, which SF_ISA_FP16 contracts.   */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+fma(const simd<T, N>& a, const simd<T, N>& b, const simd<T, N>& c) {
+    if constexpr (std::is_floating_point<T>::value) {
+        #if defined(SF_ISA_FMA)
+            #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_fma)
+                return simd<T, N> { __builtin_elementwise_fma(a.data, b.data, c.data) };
+            #else
+                simd<T, N> result;
+                for (std::size_t i = 0; i < N; ++i) {
+                     result.data[i] = std::fma(a.data[i], b.data[i], c.data[i]);
+                }
+                return result;
+            #endif
+        #endif
+    }
+    return a * b + c;
+}
+
+/* Element-wise minimum. If a lane of either input is NaN the result lane */
+/* is unspecified.                                                        */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+min(const simd<T, N>& a, const simd<T, N>& b) {
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_min)
+        return simd<T, N> { __builtin_elementwise_min(a.data, b.data) };
+    #else
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = b.data[i] < a.data[i] ? b.data[i] : a.data[i];
+        }
+        return result;
+    #endif
+}
+
+/* Element-wise maximum, with the same NaN caveat as min. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+max(const simd<T, N>& a, const simd<T, N>& b) {
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_max)
+        return simd<T, N> { __builtin_elementwise_max(a.data, b.data) };
+    #else
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = b.data[i] > a.data[i] ? b.data[i] : a.data[i];
+        }
+        return result;
+    #endif
+}
+
+/* Clamp each lane to [lo, hi]. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+clamp(const simd<T, N>& x, const simd<T, N>& lo, const simd<T, N>& hi) {
+    return min(max(x, lo), hi);
+}
+
+/* Element-wise absolute value. Unsigned lanes are returned unchanged. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+abs(const simd<T, N>& x) {
+    if constexpr (std::is_unsigned<T>::value) {
+        return x;
+    } else if constexpr (detail::is_half_float<T>) {
+        return convert<T>(abs(convert<float>(x)));
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_abs)
+            return simd<T, N> { __builtin_elementwise_abs(x.data) };
+        #else
+            simd<T, N> result;
+            for (std::size_t i = 0; i < N; ++i) {
+                if constexpr (std::is_floating_point<T>::value) {
+                    result.data[i] = std::fabs(x.data[i]);
+                } else {
+                    result.data[i] = x.data[i] < T(0) ? T(-x.data[i]) : x.data[i];
+                }
+            }
+            return result;
+        #endif
+    }
+}
+
+/* Lanes at or above this magnitude are already integers. */
+template<typename T>
+inline constexpr T integral_threshold = 
+std::is_same<T, float>::value ? T(8388608.0) : T(4503599627370496.0);
+
+/* Copy the sign of each lane of s onto the magnitude of x. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+copysign(const simd<T, N>& x, const simd<T, N>& s) {
+    static_assert(std::is_floating_point<T>::value || detail::is_half_float<T>,
+                  "copysign requires floating-point lanes");
+    if constexpr (detail::is_half_float<T>) {
+        return convert<T>(copysign(convert<float>(x), convert<float>(s)));
+    } else {
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = std::copysign(x.data[i], s.data[i]);
+        }
+        return result;
+    }
+}
+
+namespace detail {
+
+/* Rounding directions, numbered as the SSE4.1 rounding immediate. */
+enum class rounding : int {
+    nearest     = 0,
+    down        = 1,
+    up          = 2,
+    toward_zero = 3
+};
+
+/* Rounds the leading lanes of x in direction R with SSE4.1 roundps,   */
+/* AVX-512 vrndscaleps or AArch64 frint, and returns how many it       */
+/* rounded. nearest breaks ties to even, as the current mode does.     */
+template<rounding R, typename T, std::size_t N>
+sf_inline std::size_t
+round_lanes(const simd<T, N>& x, simd<T, N>& result) {
+    std::size_t i = 0;
+    #if defined(__SSE4_1__) || defined(SF_ISA_AVX)
+    constexpr int mode = static_cast<int>(R) | _MM_FROUND_NO_EXC;
+    if constexpr (std::is_same<T, float>::value) {
+        #if defined(SF_ISA_AVX512F)
+        /* Full-mask forms; the unmasked intrinsics trip -Wuninitialized on GCC. */
+        for (; i + 16 <= N; i += 16) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm512_maskz_roundscale_ps(__mmask16(0xFFFF), 
+                                                    load_chunk<__m512>(&x.data, 4 * i), 
+                                                    mode));
+        }
+        #endif
+        #if defined(SF_ISA_AVX)
+        for (; i + 8 <= N; i += 8) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm256_round_ps(load_chunk<__m256>(&x.data, 4 * i), mode));
+        }
+        #endif
+        for (; i + 4 <= N; i += 4) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm_round_ps(load_chunk<__m128>(&x.data, 4 * i), mode));
+        }
+    } else if constexpr (std::is_same<T, double>::value) {
+        #if defined(SF_ISA_AVX512F)
+        for (; i + 8 <= N; i += 8) {
+             store_chunk(&result.data, 8 * i, 
+                         _mm512_maskz_roundscale_pd(__mmask8(0xFF), 
+                                                    load_chunk<__m512d>(&x.data, 8 * i), 
+                                                    mode));
+        }
+        #endif
+        #if defined(SF_ISA_AVX)
+        for (; i + 4 <= N; i += 4) {
+             store_chunk(&result.data, 8 * i, 
+                         _mm256_round_pd(load_chunk<__m256d>(&x.data, 8 * i), mode));
+        }
+        #endif
+        for (; i + 2 <= N; i += 2) {
+             store_chunk(&result.data, 8 * i, 
+                         _mm_round_pd(load_chunk<__m128d>(&x.data, 8 * i), mode));
+        }
+    }
+    #elif defined(SF_ISA_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    if constexpr (std::is_same<T, float>::value) {
+        for (; i + 4 <= N; i += 4) {
+             const float32x4_t v = load_chunk<float32x4_t>(&x.data, 4 * i);
+             store_chunk(&result.data, 4 * i, 
+                         R == rounding::nearest ? vrndnq_f32(v) :
+                         R == rounding::down    ? vrndmq_f32(v) :
+                         R == rounding::up      ? vrndpq_f32(v) : vrndq_f32(v));
+        }
+    } else if constexpr (std::is_same<T, double>::value) {
+        for (; i + 2 <= N; i += 2) {
+             const float64x2_t v = load_chunk<float64x2_t>(&x.data, 8 * i);
+             store_chunk(&result.data, 8 * i, 
+                         R == rounding::nearest ? vrndnq_f64(v) :
+                         R == rounding::down    ? vrndmq_f64(v) :
+                         R == rounding::up      ? vrndpq_f64(v) : vrndq_f64(v));
+        }
+    }
+    #endif
+    sf_unused_parameter(x);
+    sf_unused_parameter(result);
+    return i;
+}
+
+/* Returns x unchanged, in a way the optimizer cannot see through. The */
+/* magic-number rounding (x + 2^23) - 2^23 depends on the intermediate */
+/* rounding, and -ffast-math (-fassociative-math) would otherwise fold */
+/* it to x.                                                            */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+value_barrier(simd<T, N> x) {
+    if (!std::is_constant_evaluated()) {
+        #if (defined(__GNUC__) || defined(__clang__)) && defined(SF_ISA_SSE2)
+        if constexpr (sizeof(T) * N % 16 == 0) {
+            for (std::size_t i = 0; i < sizeof(T) * N; i += 16) {
+                 __m128 v = load_chunk<__m128>(&x.data, i);
+                 __asm__("" : "+x"(v));
+                 store_chunk(&x.data, i, v);
+            }
+        } else {
+            __asm__("" : "+m"(x.data));
+        }
+        #elif defined(__GNUC__) || defined(__clang__)
+        __asm__("" : "+m"(x.data));
+        #endif
+    }
+    return x;
+}
+
+/* Rounds x in direction R without rounding instructions: |x| is rounded */
+/* to nearest by adding and subtracting 2^23 (2^52 for double), the sign */
+/* is copied back so that -0 and negative lanes are preserved, and a     */
+/* compare corrects toward the direction. Lanes at or above 2^23 are     */
+/* already integers and are returned as they are.                        */
+template<rounding R, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+round_magic(const simd<T, N>& x) {
+    const simd<T, N> magic(integral_threshold<T>);
+    const simd<T, N> a = abs(x);
+    simd<T, N>       r = value_barrier(a + magic) - magic;
+    if constexpr (R != rounding::nearest) {
+        r = select<T, N>(r > a, r - T(1), r);
+    }
+    const simd<T, N> t = select<T, N>(a < magic, copysign(r, x), x);
+    if constexpr (R == rounding::down) {
+        return select<T, N>(t > x, t - T(1), t);
+    } else if constexpr (R == rounding::up) {
+        return select<T, N>(t < x, t + T(1), t);
+    } else {
+        return t;
+    }
+}
+
+/* x rounded in direction R: by instruction where round_lanes covers */
+/* every lane, and by round_magic otherwise.                         */
+template<rounding R, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+round_to(const simd<T, N>& x) {
+    if (!std::is_constant_evaluated()) {
+        simd<T, N> result;
+        if (round_lanes<R>(x, result) == N) {
+            return result;
+        }
+    }
+    return round_magic<R>(x);
+}
+
+} /* namespace detail */
+
+/* Round toward zero. GCC keeps std::trunc/floor/ceil/round scalar under */
+/* the default -ftrapping-math, so these use the SSE4.1, AVX-512 and     */
+/* AArch64 rounding instructions, and otherwise detail::round_magic.     */
+/* Half-precision lanes are rounded as float, which represents them all. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+trunc(const simd<T, N>& x) {
+    if constexpr (std::is_integral<T>::value) {
+        return x;
+    } else if constexpr (detail::is_half_float<T>) {
+        return convert<T>(trunc(convert<float>(x)));
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_trunc)
+            return simd<T, N> { __builtin_elementwise_trunc(x.data) };
+        #else
+            return detail::round_to<detail::rounding::toward_zero>(x);
+        #endif
+    }
+}
+
+/* Round toward negative infinity. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+floor(const simd<T, N>& x) {
+    if constexpr (std::is_integral<T>::value) {
+        return x;
+    } else if constexpr (detail::is_half_float<T>) {
+        return convert<T>(floor(convert<float>(x)));
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_floor)
+            return simd<T, N> { __builtin_elementwise_floor(x.data) };
+        #else
+            return detail::round_to<detail::rounding::down>(x);
+        #endif
+    }
+}
+
+/* Round toward positive infinity. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+ceil(const simd<T, N>& x) {
+    if constexpr (std::is_integral<T>::value) {
+        return x;
+    } else if constexpr (detail::is_half_float<T>) {
+        return convert<T>(ceil(convert<float>(x)));
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_ceil)
+            return simd<T, N> { __builtin_elementwise_ceil(x.data) };
+        #else
+            return detail::round_to<detail::rounding::up>(x);
+        #endif
+    }
+}
+
+/* Round to nearest, with halfway cases away from zero like std::round. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+round(const simd<T, N>& x) {
+    if constexpr (std::is_integral<T>::value) {
+        return x;
+    } else if constexpr (detail::is_half_float<T>) {
+        return convert<T>(round(convert<float>(x)));
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_round)
+            return simd<T, N> { __builtin_elementwise_round(x.data) };
+        #else
+            const simd<T, N> a = abs(x);
+            const simd<T, N> t = trunc(a);
+            return copysign(select<T, N>(a - t >= T(0.5), t + T(1), t), x);
+        #endif
+    }
+}
+
+/*-----------------*/
+/* Type Conversion */
+/*-----------------*/
+
+/* Element type twice as wide as T with the same signedness. */
+template<typename T> struct widened_element;
+template<> struct widened_element<std::int8_t>   { using type = std::int16_t;  };
+template<> struct widened_element<std::uint8_t>  { using type = std::uint16_t; };
+template<> struct widened_element<std::int16_t>  { using type = std::int32_t;  };
+template<> struct widened_element<std::uint16_t> { using type = std::uint32_t; };
+template<> struct widened_element<std::int32_t>  { using type = std::int64_t;  };
+template<> struct widened_element<std::uint32_t> { using type = std::uint64_t; };
+template<> struct widened_element<float>         { using type = double;        };
+#if defined(SF_HAS_FLOAT16)
+template<> struct widened_element<float16_t>     { using type = float;         };
+#endif
+
+/* Element type half as wide as T with the same signedness. */
+template<typename T> struct narrowed_element;
+template<> struct narrowed_element<std::int16_t>  { using type = std::int8_t;   };
+template<> struct narrowed_element<std::uint16_t> { using type = std::uint8_t;  };
+template<> struct narrowed_element<std::int32_t>  { using type = std::int16_t;  };
+template<> struct narrowed_element<std::uint32_t> { using type = std::uint16_t; };
+template<> struct narrowed_element<std::int64_t>  { using type = std::int32_t;  };
+template<> struct narrowed_element<std::uint64_t> { using type = std::uint32_t; };
+
+namespace detail {
+
+/* Converts the leading lanes of x between float16_t and float with F16C */
+/* or AArch64 fcvtl/fcvtn and returns how many it converted. GCC keeps   */
+/* a lane loop of these casts scalar, one vcvtph2ps per lane.            */
+template<typename U, typename T, std::size_t N>
+sf_inline std::size_t
+convert_half_lanes(const simd<T, N>& x, simd<U, N>& result) {
+    std::size_t i = 0;
+    #if defined(SF_HAS_FLOAT16) && defined(SF_ISA_F16C)
+    if constexpr (std::is_same<T, float16_t>::value && std::is_same<U, float>::value) {
+        #if defined(SF_ISA_AVX512F)
+        /* Full-mask forms; the unmasked intrinsics trip -Wuninitialized on GCC. */
+        for (; i + 16 <= N; i += 16) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm512_maskz_cvtph_ps(__mmask16(0xFFFF), 
+                                               load_chunk<__m256i>(&x.data, 2 * i)));
+        }
+        #endif
+        for (; i + 8 <= N; i += 8) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm256_cvtph_ps(load_chunk<__m128i>(&x.data, 2 * i)));
+        }
+        for (; i + 4 <= N; i += 4) {
+             store_chunk(&result.data, 4 * i, 
+                         _mm_cvtph_ps(_mm_loadl_epi64(
+                             reinterpret_cast<const __m128i*>(&x.data[i]))));
+        }
+    } else if constexpr (std::is_same<T, float>::value && std::is_same<U, float16_t>::value) {
+        #if defined(SF_ISA_AVX512F)
+        for (; i + 16 <= N; i += 16) {
+             store_chunk(&result.data, 2 * i, 
+                         _mm512_maskz_cvtps_ph(__mmask16(0xFFFF), 
+                                               load_chunk<__m512>(&x.data, 4 * i), 
+                                               _MM_FROUND_CUR_DIRECTION));
+        }
+        #endif
+        for (; i + 8 <= N; i += 8) {
+             store_chunk(&result.data, 2 * i, 
+                         _mm256_cvtps_ph(load_chunk<__m256>(&x.data, 4 * i), 
+                                         _MM_FROUND_CUR_DIRECTION));
+        }
+        for (; i + 4 <= N; i += 4) {
+             _mm_storel_epi64(reinterpret_cast<__m128i*>(&result.data[i]), 
+                              _mm_cvtps_ph(load_chunk<__m128>(&x.data, 4 * i), 
+                                           _MM_FROUND_CUR_DIRECTION));
+        }
+    }
+    #elif defined(SF_HAS_FLOAT16) && defined(SF_ISA_NEON) && defined(__aarch64__)
+    if constexpr (std::is_same<T, float16_t>::value && std::is_same<U, float>::value) {
+        for (; i + 4 <= N; i += 4) {
+             store_chunk(&result.data, 4 * i, 
+                         vcvt_f32_f16(load_chunk<float16x4_t>(&x.data, 2 * i)));
+        }
+    } else if constexpr (std::is_same<T, float>::value && std::is_same<U, float16_t>::value) {
+        for (; i + 4 <= N; i += 4) {
+             store_chunk(&result.data, 2 * i, 
+                         vcvt_f16_f32(load_chunk<float32x4_t>(&x.data, 4 * i)));
+        }
+    }
+    #endif
+    sf_unused_parameter(x);
+    sf_unused_parameter(result);
+    return i;
+}
+
+} /* namespace detail */
+
+/* Convert each lane to U as if by static_cast. Float to integer truncates */
+/* toward zero; lanes outside the range of U are undefined, as for scalar. */
+/* float16_t to and from float uses F16C or NEON where they are enabled.   */
+template<typename U, typename T, std::size_t N>
+constexpr sf_inline simd<U, N>
+convert(const simd<T, N>& x) {
+    #if defined(__clang__)
+        simd<U, N> result;
+        result.data = __builtin_convertvector(x.data, 
+                                              typename simd<U, N>::vector_type);
+        return result;
+    #else
+        simd<U, N> result;
+        std::size_t i = 0;
+        if (!std::is_constant_evaluated()) {
+            i = detail::convert_half_lanes(x, result);
+        }
+        for (; i < N; ++i) {
+             result.data[i] = static_cast<U>(x.data[i]);
+        }
+        return result;
+    #endif
+}
+
+/* Value-preserving conversion to U. Rejected at compile time when some */
+/* value of T is not representable in U; use convert for those.        */
+template<typename U, typename T, std::size_t N>
+constexpr sf_inline simd<U, N>
+simd_cast(const simd<T, N>& x) {
+    static_assert(requires(T value) { U { value }; },
+                  "simd_cast would narrow; use convert<U> instead");
+    return convert<U>(x);
+}
+
+/* Reinterpret the bits of x as lanes of U. The total size is unchanged, */
+/* so simd<float, 8> becomes simd<std::uint32_t, 8> or simd<double, 4>.  */
+template<typename U, typename T, std::size_t N>
+constexpr sf_inline simd<U, sizeof(T) * N / sizeof(U)>
+bit_cast(const simd<T, N>& x) {
+    static_assert(sizeof(T) * N % sizeof(U) == 0, 
+                  "bit_cast requires vectors of equal size");
+    if constexpr (std::is_same<U, T>::value) {
+        return x;
+    } else {
+    simd<U, sizeof(T) * N / sizeof(U)> result;
+        #if !defined(__clang__)
+        /* GCC lowers std::bit_cast of an array through general registers. */
+        if (!std::is_constant_evaluated()) {
+            result.load(reinterpret_cast<const U*>(x.data.data()));
+            return result;
+        }
+        #endif
+    result.data = std::bit_cast<decltype(result.data)>(x.data);
+    return result;
+    }
+}
+
+/* Widen the low half of x to lanes twice as wide, sign-extending signed */
+/* and zero-extending unsigned lanes; float widens to double.            */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<typename widened_element<T>::type, N/2>
+widen_low(const simd<T, N>& x) {
+    static_assert(N % 2 == 0, "widen_low size must be even");
+    using W = typename widened_element<T>::type;
+    return convert<W>(x.template get_low<N/2>());
+}
+
+/* Widen the high half of x, as widen_low. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<typename widened_element<T>::type, N/2>
+widen_high(const simd<T, N>& x) {
+    static_assert(N % 2 == 0, "widen_high size must be even");
+    using W = typename widened_element<T>::type;
+    return convert<W>(x.template get_high<N/2>());
+}
+
+/* Narrow a and b to U with saturation and concatenate them, a in the low */
+/* lanes. U may differ in signedness from T, so narrow_pack<std::uint8_t> */
+/* on int16_t lanes clamps to [0, 255] like packuswb.                     */
+template<typename U, typename T, std::size_t N>
+constexpr sf_inline simd<U, 2*N>
+narrow_pack(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value && std::is_integral<U>::value &&
+                  sizeof(U) < sizeof(T),
+                  "narrow_pack requires a narrower integral target type");
+    const simd<T, N> hi(static_cast<T>(std::numeric_limits<U>::max()));
+    if constexpr (std::is_signed<T>::value) {
+        const simd<T, N> lo(static_cast<T>(std::numeric_limits<U>::lowest()));
+        return merge(convert<U>(clamp(a, lo, hi)), convert<U>(clamp(b, lo, hi)));
+    } else {
+        return merge(convert<U>(min(a, hi)), convert<U>(min(b, hi)));
+    }
+}
+
+/* Narrow a and b to the half-width type of the same signedness. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<typename narrowed_element<T>::type, 2*N>
+narrow_pack(const simd<T, N>& a, const simd<T, N>& b) {
+    return narrow_pack<typename narrowed_element<T>::type>(a, b);
+}
+
+/* bfloat16 bit patterns of x, rounded to nearest even, for storing or  */
+/* uploading where the compiler has no bfloat16_t. NaN lanes are kept   */
+/* NaN by quieting them instead of letting the rounding carry into inf. */
+template<std::size_t N>
+constexpr sf_inline simd<std::uint16_t, N>
+to_bfloat16_bits(const simd<float, N>& x) {
+    using U = simd<std::uint32_t, N>;
+    const U bits    = bit_cast<std::uint32_t>(x);
+    const U rounded = bits + ((bits >> 16u) & 1u) + 0x7FFFu;
+    const U quiet   = bits | 0x00400000u;
+    const auto nan  = (bits & 0x7FFFFFFFu) > 0x7F800000u;
+    return convert<std::uint16_t>(select<std::uint32_t, N>(nan, quiet, rounded) >> 16u);
+}
+
+/* Floats with the given bfloat16 bit patterns; exact. */
+template<std::size_t N>
+constexpr sf_inline simd<float, N>
+from_bfloat16_bits(const simd<std::uint16_t, N>& bits) {
+    return bit_cast<float>(convert<std::uint32_t>(bits) << 16u);
+}
+
+/*---------------------------------------*/
+/* Saturating and Fixed-Point Arithmetic */
+/*---------------------------------------*/
+
+/* Computes a + b, clamping lanes that overflow to the limits of T. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+adds(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value, "adds requires integral lanes");
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_add_sat)
+        return simd<T, N> { __builtin_elementwise_add_sat(a.data, b.data) };
+    #else
+        using U = typename std::make_unsigned<T>::type;
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+            if constexpr (std::is_unsigned<T>::value) {
+                 const T room = T(~b.data[i]);
+                 result.data[i] = T(b.data[i] + (a.data[i] < room ? a.data[i] : room));
+            } else {
+                 /* Overflowed iff the sum's sign differs from both inputs'. */
+                 const T sum = T(U(a.data[i]) + U(b.data[i]));
+                 const T sat = T((a.data[i] >> (sizeof(T) * 8 - 1)) ^ 
+                                 std::numeric_limits<T>::max());
+                 result.data[i] = T((a.data[i] ^ sum) & (b.data[i] ^ sum)) < 0 ? 
+                                  sat : sum;
+            }
+        }
+        return result;
+    #endif
+}
+
+/* Computes a - b, clamping lanes that overflow to the limits of T. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+subs(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value, "subs requires integral lanes");
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_sub_sat)
+        return simd<T, N> { __builtin_elementwise_sub_sat(a.data, b.data) };
+    #else
+        using U = typename std::make_unsigned<T>::type;
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+            if constexpr (std::is_unsigned<T>::value) {
+                 const T low = b.data[i] < a.data[i] ? b.data[i] : a.data[i];
+                 result.data[i] = T(a.data[i] - low);
+            } else {
+                 /* Overflowed iff the inputs' signs differ and the result's */
+                 /* sign differs from a's.                                  */
+                 const T diff = T(U(a.data[i]) - U(b.data[i]));
+                 const T sat  = T((a.data[i] >> (sizeof(T) * 8 - 1)) ^ 
+                                  std::numeric_limits<T>::max());
+                 result.data[i] = T((a.data[i] ^ b.data[i]) & (a.data[i] ^ diff)) < 0 ? 
+                                  sat : diff;
+            }
+        }
+        return result;
+    #endif
+}
+
+/* Rounding average (a + b + 1) >> 1, computed without overflow. Halfway */
+/* cases round toward positive infinity, matching pavgb/urhadd.          */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+avg(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value, "avg requires integral lanes");
+    simd<T, N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+        if constexpr (sizeof(T) < 8) {
+             using W = typename widened_element<T>::type;
+             result.data[i] = T((W(a.data[i]) + W(b.data[i]) + 1) >> 1);
+        } else {
+             result.data[i] = T((a.data[i] | b.data[i]) - 
+                                ((a.data[i] ^ b.data[i]) >> 1));
+        }
+    }
+    return result;
+}
+
+/* High half of the full-width product a * b, as pmulhw/pmulhuw/smulh. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+mulhi(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value, "mulhi requires integral lanes");
+    simd<T, N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+        if constexpr (sizeof(T) < 8) {
+             using W = typename widened_element<T>::type;
+             result.data[i] = T((W(a.data[i]) * W(b.data[i])) >> (sizeof(T) * 8));
+        } else {
+             /* Schoolbook 32x32 partial products; the signed high half is */
+             /* the unsigned one corrected for each negative operand.      */
+             const std::uint64_t x  = std::uint64_t(a.data[i]);
+             const std::uint64_t y  = std::uint64_t(b.data[i]);
+             const std::uint64_t xl = x & 0xFFFFFFFFu, xh = x >> 32;
+             const std::uint64_t yl = y & 0xFFFFFFFFu, yh = y >> 32;
+             const std::uint64_t t  = xh * yl + ((xl * yl) >> 32);
+             const std::uint64_t w  = (t & 0xFFFFFFFFu) + xl * yh;
+             std::uint64_t       hi = xh * yh + (t >> 32) + (w >> 32);
+             if constexpr (std::is_signed<T>::value) {
+                 hi -= (a.data[i] < 0 ? y : 0) + (b.data[i] < 0 ? x : 0);
+             }
+             result.data[i] = T(hi);
+        }
+    }
+    return result;
+}
+
+/* Computes |a - b| without overflow. The result is unsigned so that the */
+/* full range of signed differences, up to 2^bits - 1, is representable. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<typename std::make_unsigned<T>::type, N>
+abs_diff(const simd<T, N>& a, const simd<T, N>& b) {
+    static_assert(std::is_integral<T>::value, "abs_diff requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    simd<U, N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = a.data[i] > b.data[i] ? U(U(a.data[i]) - U(b.data[i])) 
+                                                : U(U(b.data[i]) - U(a.data[i]));
+    }
+    return result;
+}
+
+/*------------------*/
+/* Bit Manipulation */
+/*------------------*/
+
+namespace detail {
+
+/* True when a plain loop of std::popcount or std::countl_zero over lanes */
+/* of the given size vectorizes to one instruction per register, so GCC   */
+/* needs no help: VPOPCNTDQ, BITALG and CD on AVX-512, cnt and clz on     */
+/* NEON. Elsewhere the operations are built from shifts and lookups.      */
+template<std::size_t Size>
+inline constexpr bool has_vector_popcount =
+#if defined(SF_ISA_AVX512F) && defined(__AVX512VL__) && defined(__AVX512VPOPCNTDQ__)
+    Size >= 4 ||
+#endif
+#if defined(SF_ISA_AVX512F) && defined(__AVX512VL__) && defined(__AVX512BITALG__)
+    Size <= 2 ||
+#endif
+#if defined(SF_ISA_NEON)
+    Size == 1 ||
+#endif
+    false;
+
+template<std::size_t Size>
+inline constexpr bool has_vector_countl_zero =
+#if defined(SF_ISA_AVX512F) && defined(__AVX512VL__) && defined(__AVX512CD__)
+    Size >= 4 ||
+#endif
+#if defined(SF_ISA_NEON)
+    Size <= 4 ||
+#endif
+    false;
+
+/* Set bits in each byte of x. With pshufb or tbl both nibbles are looked */
+/* up in a 16-entry table, lookup taking the low one modulo 16; otherwise */
+/* bit pairs, then nibbles, are summed in place.                          */
+template<typename U, std::size_t N>
+constexpr sf_always_inline simd<U, N>
+popcount_bytes(const simd<U, N>& x) {
+    #if (defined(SF_ISA_SSE2) && defined(__SSSE3__)) || defined(SF_ISA_NEON)
+    if constexpr (sizeof(U) * N % 16 == 0) {
+        constexpr simd<std::uint8_t, 16> table {
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+        };
+        const auto bytes = bit_cast<std::uint8_t>(x);
+        return bit_cast<U>(lookup(table, bytes) + lookup(table, bytes >> std::uint8_t(4)));
+    }
+    #endif
+    const simd<U, N> pairs   = x - ((x >> U(1)) & U(U(-1) / 3));
+    const simd<U, N> nibbles = (pairs & U(U(-1) / 5)) + ((pairs >> U(2)) & U(U(-1) / 5));
+    return (nibbles + (nibbles >> U(4))) & U(U(-1) / 17);
+}
+
+/* Sum of the bytes of each lane of x, for byte values below 16. Every */
+/* step names a new vector: GCC copies reassigned ones through memory. */
+template<typename U, std::size_t N>
+constexpr sf_always_inline simd<U, N>
+sum_bytes(const simd<U, N>& x) {
+    if constexpr (sizeof(U) == 1) {
+        return x;
+    } else if constexpr (sizeof(U) == 2) {
+        return (x + (x >> U(8))) & U(0x1F);
+    } else {
+        const simd<U, N> h = x + (x >> U(8));
+        if constexpr (sizeof(U) == 4) {
+            return (h + (h >> U(16))) & U(0x3F);
+        } else {
+            const simd<U, N> w = h + (h >> U(16));
+            return (w + (w >> U(32))) & U(0x7F);
         }
-        return simd<T, N> { result };
-    #endif
+    }
 }
 
-/* Blend two vectors according to immediate constant mask */
-template<std::size_t... I, typename T, std::size_t N>
-constexpr sf_inline simd<T, N>
-blend(const simd<T, N>& a, const simd<T, N>& b) {
-    #if defined(__clang__)
+/* x with every bit below the highest set bit of each lane also set, */
+/* by ORing in x shifted right by S, 2S, 4S, ... bits.               */
+template<std::size_t S, typename U, std::size_t N>
+constexpr sf_always_inline simd<U, N>
+smear_right(const simd<U, N>& x) {
+    if constexpr (S >= sizeof(U) * 8) {
+        return x;
+    } else {
+        return smear_right<2 * S>(x | (x >> U(S)));
+    }
+}
+
+/* Set bits in each lane of x, as scl::popcount but without its profile */
+/* hook, for the bit operations that are built on it.                   */
+template<typename T, std::size_t N>
+constexpr sf_always_inline simd<T, N>
+popcount_lanes(const simd<T, N>& x) {
+    using U = typename std::make_unsigned<T>::type;
+    if constexpr (has_vector_popcount<sizeof(T)>) {
         simd<T, N> result;
-        constexpr bool mask[N] = { ((I < N) ? true : false)... };
         for (std::size_t i = 0; i < N; ++i) {
-             result.data[i] = mask[i] ? a.data[i] : b.data[i];
+             result.data[i] = T(std::popcount(U(x.data[i])));
         }
         return result;
+    } else {
+        return bit_cast<T>(sum_bytes(popcount_bytes(bit_cast<U>(x))));
+    }
+}
+
+} /* namespace detail */
+
+/* Number of set bits in each lane, as std::popcount. Without a vector */
+/* popcount instruction the bytes are counted first and their counts   */
+/* summed across the lane with log2(sizeof(T)) shifts and adds.        */
+template<typename T, std::size_t N>
+constexpr sf_always_inline simd<T, N>
+popcount(const simd<T, N>& x) {
+    static_assert(std::is_integral<T>::value, "popcount requires integral lanes");
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_popcount)
+        return simd<T, N> { __builtin_elementwise_popcount(x.data) };
     #else
-        std::array<T, N> result;
-        constexpr bool mask[N] = { ((I < N) ? true : false)... };
-        for (std::size_t i = 0; i < N; ++i) {
-             result[i] = mask[i] ? a.data[i] : b.data[i];
+        if constexpr (!detail::has_vector_popcount<sizeof(T)>) {
+            scl_profile_count(popcount_emulated);
         }
-        return simd<T, N> { result };
+        return detail::popcount_lanes(x);
     #endif
 }
 
-/* Permute elements in simd vector according to immediate indices */
-template<std::size_t... I, typename T, std::size_t N>
-constexpr sf_inline simd<T, sizeof...(I)>
-permute(const simd<T, N>& vector) {
-    static_assert(sizeof...(I) <= N, "Too many indices for simd vector size");
-    
-    #if defined(__clang__)
-        using result_type = simd<T, sizeof...(I)>;
-        typename result_type::vector_type result;
-        constexpr std::size_t indices[] = { I... };
-        for (std::size_t i = 0; i < sizeof...(I); ++i) {
-             result[i] = vector.data[indices[i]];
-        }
-        return result_type { result };
+/* Number of leading zero bits in each lane, as std::countl_zero, so */
+/* zero lanes give the lane width. The fallback smears the highest   */
+/* set bit down through the lane and counts the zeros left above it. */
+template<typename T, std::size_t N>
+constexpr sf_always_inline simd<T, N>
+countl_zero(const simd<T, N>& x) {
+    static_assert(std::is_integral<T>::value, "countl_zero requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_clzg)
+        return simd<T, N> { __builtin_elementwise_clzg(x.data, simd<T, N>(T(sizeof(T) * 8)).data) };
     #else
-        std::array<T, sizeof...(I)> result;
-        constexpr std::size_t indices[] = { I... };
-        for (std::size_t i = 0; i < sizeof...(I); ++i) {
-             result[i] = vector.data[indices[i]];
+        if constexpr (detail::has_vector_countl_zero<sizeof(T)>) {
+            simd<T, N> result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 result.data[i] = T(std::countl_zero(U(x.data[i])));
+            }
+            return result;
+        } else {
+            scl_profile_count(countl_zero_emulated);
+            return detail::popcount_lanes(bit_cast<T>(~detail::smear_right<1>(bit_cast<U>(x))));
         }
-        return simd<T, sizeof...(I)> { result };
     #endif
 }
 
-/* Shuffle elements from two vectors according to immediate indices */
-template<std::size_t... I, typename T, std::size_t N>
-constexpr sf_inline simd<T, sizeof...(I)>
-shuffle(const simd<T, N>& a, const simd<T, N>& b) {
-    static_assert(sizeof...(I) <= 2*N, 
-                  "Too many indices for simd vector size");
-    
-    #if defined(__clang__)
-        using result_type = simd<T, sizeof...(I)>;
-        typename result_type::vector_type result;
-        constexpr std::size_t indices[] = { I... };
-        for (std::size_t i = 0; i < sizeof...(I); ++i) {
-            if (indices[i] < N) {
-                result[i] = a.data[indices[i]];
-            } else {
-                result[i] = b.data[indices[i] - N];
-            }
-        }
-        return result_type{result};
+/* Number of trailing zero bits in each lane, as std::countr_zero. The */
+/* lanes of ~x & (x - 1) have exactly those bits set, which are then   */
+/* counted directly or, with only a vector lzcnt, as width - clz.      */
+template<typename T, std::size_t N>
+constexpr sf_always_inline simd<T, N>
+countr_zero(const simd<T, N>& x) {
+    static_assert(std::is_integral<T>::value, "countr_zero requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_ctzg)
+        return simd<T, N> { __builtin_elementwise_ctzg(x.data, simd<T, N>(T(sizeof(T) * 8)).data) };
     #else
-        std::array<T, sizeof...(I)> result;
-        constexpr std::size_t indices[] = { I... };
-        for (std::size_t i = 0; i < sizeof...(I); ++i) {
-            if (indices[i] < N) {
-                result[i] = a.data[indices[i]];
-            } else {
-                result[i] = b.data[indices[i] - N];
+        const simd<U, N> v     = bit_cast<U>(x);
+        const simd<T, N> below = bit_cast<T>(~v & (v - U(1)));
+        if constexpr (!detail::has_vector_popcount<sizeof(T)> && 
+                      detail::has_vector_countl_zero<sizeof(T)>) {
+            return simd<T, N>(T(sizeof(T) * 8)) - countl_zero(below);
+        } else {
+            if constexpr (!detail::has_vector_popcount<sizeof(T)>) {
+                scl_profile_count(countr_zero_emulated);
             }
+            return detail::popcount_lanes(below);
         }
-        return simd<T, sizeof...(I)> { result };
     #endif
 }
 
-/* Swap two simd vectors */
+/* Rotate each lane left by s bits, as std::rotl, so negative s rotates */
+/* right. Both shifts are masked to the lane width, the form GCC and    */
+/* Clang match to vprold/vprolq on AVX-512; elsewhere it is two shifts  */
+/* and an or.                                                           */
 template<typename T, std::size_t N>
-constexpr sf_inline void
-swap(simd<T, N>& a, simd<T, N>& b) {
-    simd<T, N> temp = a;
-               a    = b;
-               b    = temp;
+constexpr sf_inline simd<T, N>
+rotl(const simd<T, N>& x, int s) {
+    static_assert(std::is_integral<T>::value, "rotl requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    constexpr unsigned bits = sizeof(T) * 8;
+    const simd<U, N> v = bit_cast<U>(x);
+    const U          r = U(unsigned(s) & (bits - 1));
+    return bit_cast<T>((v << r) | (v >> U((bits - r) & (bits - 1))));
 }
 
-/* Sign combine two simd vectors */
+/* Rotate each lane left by the matching lane of s, modulo the width. */
 template<typename T, std::size_t N>
 constexpr sf_inline simd<T, N>
-sign_combine(const simd<T, N>& a, const simd<T, N>& b) {
-    #if defined(__clang__)
-        return simd<T, N> { a.data ^ 
-                           (b.data & (T(1) << (sizeof(T) * 8 - 1))) };
-    #else
-        std::array<T, N> result;
-        for (std::size_t i = 0; i < N; ++i) {
-             result[i] = a.data[i] ^ 
-                        (b.data[i] & (T(1) << (sizeof(T) * 8 - 1)));
-        }
-        return simd<T, N> { result };
-    #endif
+rotl(const simd<T, N>& x, const simd<T, N>& s) {
+    static_assert(std::is_integral<T>::value, "rotl requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    constexpr U bits = U(sizeof(T) * 8);
+    const simd<U, N> v = bit_cast<U>(x);
+    const simd<U, N> r = bit_cast<U>(s) & U(bits - 1);
+    return bit_cast<T>((v << r) | (v >> ((bits - r) & U(bits - 1))));
 }
 
-/* Split simd vector into two simd vectors. */
+/* Rotate each lane right by s bits, as std::rotr. */
 template<typename T, std::size_t N>
-constexpr sf_inline std::pair<simd<T, N/2>, simd<T, N/2>>
-split(const simd<T, N>& vector) {
-    static_assert(N % 2 == 0, "Split size must be even");
-    #if defined(__clang__)
-        simd<T, N/2> a;
-        simd<T, N/2> b;
-        for (std::size_t i = 0; i < N/2; ++i) {
-             a.data[i] = vector.data[i];
-             b.data[i] = vector.data[N/2 + i];
+constexpr sf_inline simd<T, N>
+rotr(const simd<T, N>& x, int s) {
+    static_assert(std::is_integral<T>::value, "rotr requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    constexpr unsigned bits = sizeof(T) * 8;
+    const simd<U, N> v = bit_cast<U>(x);
+    const U          r = U(unsigned(s) & (bits - 1));
+    return bit_cast<T>((v >> r) | (v << U((bits - r) & (bits - 1))));
+}
+
+/* Rotate each lane right by the matching lane of s, modulo the width. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+rotr(const simd<T, N>& x, const simd<T, N>& s) {
+    static_assert(std::is_integral<T>::value, "rotr requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    constexpr U bits = U(sizeof(T) * 8);
+    const simd<U, N> v = bit_cast<U>(x);
+    const simd<U, N> r = bit_cast<U>(s) & U(bits - 1);
+    return bit_cast<T>((v >> r) | (v << ((bits - r) & U(bits - 1))));
+}
+
+/* Reverse the bytes of each lane, as std::byteswap. GCC recognizes the */
+/* shift-and-mask form below as a byte swap and vectorizes it to one    */
+/* pshufb with SSSE3 or rev on NEON; SSE2 keeps the shifts.             */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+byteswap(const simd<T, N>& x) {
+    static_assert(std::is_integral<T>::value, "byteswap requires integral lanes");
+    using U = typename std::make_unsigned<T>::type;
+    if constexpr (sizeof(T) == 1) {
+        return x;
+    } else {
+        #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_bswap)
+            return simd<T, N> { __builtin_elementwise_bswap(x.data) };
+        #else
+            simd<T, N> result;
+            for (std::size_t i = 0; i < N; ++i) {
+                 const U u = U(x.data[i]);
+                 if constexpr (sizeof(T) == 2) {
+                     result.data[i] = T(U(u << 8) | U(u >> 8));
+                 } else if constexpr (sizeof(T) == 4) {
+                     result.data[i] = T((u << 24) | ((u & 0xFF00u) << 8) | 
+                                        ((u >> 8) & 0xFF00u) | (u >> 24));
+                 } else {
+                     result.data[i] = T((u << 56) | ((u & 0xFF00u) << 40) | 
+                                        ((u & 0xFF0000u) << 24) | ((u & 0xFF000000u) << 8) | 
+                                        ((u >> 8) & 0xFF000000u) | ((u >> 24) & 0xFF0000u) | 
+                                        ((u >> 40) & 0xFF00u) | (u >> 56));
+                 }
+            }
+            return result;
+        #endif
+    }
+}
+
+/*-----------------------------*/
+/* Logical and State Functions */
+/*-----------------------------*/
+
+namespace detail {
+
+/* Sign bits of the mask lanes of width E in one 16-, 32- or 64-byte */
+/* chunk at p, one bit per lane, as movemask returns them.             */
+template<std::size_t E, std::size_t Bytes>
+sf_inline std::uint64_t
+movemask(const void* p) {
+    #if defined(SF_ISA_AVX512F) && defined(__AVX512BW__) && defined(__AVX512DQ__)
+    if constexpr (Bytes == 64) {
+        const __m512i v = _mm512_loadu_si512(p);
+        if constexpr (E == 1) {
+            return _mm512_movepi8_mask(v);
+        } else if constexpr (E == 2) {
+            return _mm512_movepi16_mask(v);
+        } else if constexpr (E == 4) {
+            return _mm512_movepi32_mask(v);
+        } else {
+            return _mm512_movepi64_mask(v);
         }
-        return std::make_pair(a, b);
-    #else
-        std::array<T, N/2> a;
-        std::array<T, N/2> b;
-        for (std::size_t i = 0; i < N/2; ++i) {
-             a[i] = vector.data[i];
-             b[i] = vector.data[N/2 + i];
+    } else
+    #endif
+    #if defined(SF_ISA_AVX2)
+    if constexpr (Bytes == 32) {
+        const __m256i v = _mm256_loadu_si256(static_cast<const __m256i*>(p));
+        if constexpr (E == 1) {
+            return std::uint32_t(_mm256_movemask_epi8(v));
+        } else if constexpr (E == 2) {
+            return std::uint32_t(_mm_movemask_epi8(
+                   _mm_packs_epi16(_mm256_castsi256_si128(v),
+                                   _mm256_extracti128_si256(v, 1))));
+        } else if constexpr (E == 4) {
+            return std::uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(v)));
+        } else {
+            return std::uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
         }
-        return std::make_pair(simd<T, N/2> { a }, simd<T, N/2> { b });
+    } else
     #endif
+    {
+        static_assert(Bytes == 16, "movemask chunk must be 16, 32 or 64 bytes");
+        #if defined(SF_ISA_SSE2)
+            const __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(p));
+            if constexpr (E == 1) {
+                return std::uint32_t(_mm_movemask_epi8(v));
+            } else if constexpr (E == 2) {
+                return std::uint32_t(_mm_movemask_epi8(
+                       _mm_packs_epi16(v, _mm_setzero_si128())));
+            } else if constexpr (E == 4) {
+                return std::uint32_t(_mm_movemask_ps(_mm_castsi128_ps(v)));
+            } else {
+                return std::uint32_t(_mm_movemask_pd(_mm_castsi128_pd(v)));
+            }
+        #elif defined(SF_ISA_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+            /* Keep one distinct power of two per lane, then add across. */
+            if constexpr (E == 1) {
+                static const std::uint8_t weights[16] = {
+                    1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+                };
+                const uint8x16_t bits = vandq_u8(vld1q_u8(static_cast<const std::uint8_t*>(p)),
+                                                 vld1q_u8(weights));
+                return std::uint32_t(vaddv_u8(vget_low_u8(bits))) |
+                       std::uint32_t(vaddv_u8(vget_high_u8(bits))) << 8;
+            } else if constexpr (E == 2) {
+                static const std::uint16_t weights[8] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+                return vaddvq_u16(vandq_u16(vld1q_u16(static_cast<const std::uint16_t*>(p)),
+                                            vld1q_u16(weights)));
+            } else if constexpr (E == 4) {
+                static const std::uint32_t weights[4] = { 1, 2, 4, 8 };
+                return vaddvq_u32(vandq_u32(vld1q_u32(static_cast<const std::uint32_t*>(p)),
+                                            vld1q_u32(weights)));
+            } else {
+                static const std::uint64_t weights[2] = { 1, 2 };
+                return vaddvq_u64(vandq_u64(vld1q_u64(static_cast<const std::uint64_t*>(p)),
+                                            vld1q_u64(weights)));
+            }
+        #else
+            const auto* lanes = static_cast<const unsigned char*>(p);
+            std::uint64_t result = 0;
+            for (std::size_t i = 0; i < Bytes / E; ++i) {
+                 result |= std::uint64_t(lanes[i * E + E - 1] >> 7) << i;
+            }
+            return result;
+        #endif
+    }
 }
 
-/* Merge two simd vectors into one simd vector. */
+/* True when movemask has a vector instruction sequence on this target. */
+inline constexpr bool has_movemask =
+#if defined(SF_ISA_SSE2) || (defined(SF_ISA_NEON) && (defined(__aarch64__) || defined(_M_ARM64)))
+    true;
+#else
+    false;
+#endif
+
+/* Chunk size movemask is called with for a mask of the given bytes. GCC */
+/* keeps 256-bit vectors on AVX-512 targets unless told otherwise, so its */
+/* masks are stored in 32-byte halves that a 64-byte reload would stall  */
+/* on; only Clang, which holds them in zmm registers, reads 64 at once.  */
+template<std::size_t Bytes>
+inline constexpr std::size_t movemask_chunk =
+#if defined(SF_ISA_AVX512F) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__clang__)
+    Bytes >= 64 ? 64 :
+#endif
+#if defined(SF_ISA_AVX2)
+    Bytes >= 32 ? 32 :
+#endif
+    16;
+
+} /* namespace detail */
+
+/* Convert boolean vector to integer bitfield, bit i set when lane i is. */
+/* Lanes are read by their sign bit, as comparisons and first_n produce  */
+/* all-ones lanes; with SSE2, AVX2, AVX-512BW or AArch64 NEON this is a  */
+/* movemask per register instead of a loop over lanes.                   */
 template<typename T, std::size_t N>
-constexpr sf_inline simd<T, 2*N>
-merge(const simd<T, N>& a, const simd<T, N>& b) {
-    #if defined(__clang__)
-        simd<T, 2*N> result;
-        for (std::size_t i = 0; i < N; ++i) {
-             result.data[i] = a.data[i];
-             result.data[N + i] = b.data[i];
+constexpr sf_inline std::size_t
+to_bitfield(const typename simd<T, N>::mask_type& mask) {
+    static_assert(N <= 64, "to_bitfield supports at most 64 lanes");
+    using element_type = typename simd<T, N>::mask_element_type;
+    constexpr std::size_t E     = sizeof(element_type);
+    constexpr std::size_t bytes = E * N;
+    constexpr std::size_t chunk = detail::movemask_chunk<bytes>;
+
+    if constexpr (detail::has_movemask && bytes % chunk == 0) {
+        /* Read the mask in place; a copy of it would go through general */
+        /* registers on GCC and stall the vector reload.                 */
+        if (!std::is_constant_evaluated()) {
+            const auto*   lanes  = reinterpret_cast<const unsigned char*>(&mask.data);
+            std::uint64_t result = 0;
+            for (std::size_t i = 0; i < bytes; i += chunk) {
+                 result |= detail::movemask<E, chunk>(lanes + i) << (i / E);
+            }
+            return std::size_t(result);
         }
-        return result;
-    #else
-        std::array<T, 2*N> result;
-        for (std::size_t i = 0; i < N; ++i) {
-             result[i] = a.data[i];
-             result[N + i] = b.data[i];
+    } else if constexpr (detail::has_movemask) {
+        if (!std::is_constant_evaluated()) {
+            unsigned char lanes[(bytes + chunk - 1) / chunk * chunk] = {};
+            std::memcpy(lanes, &mask.data, bytes);
+            std::uint64_t result = 0;
+            for (std::size_t i = 0; i < bytes; i += chunk) {
+                 result |= detail::movemask<E, chunk>(lanes + i) << (i / E);
+            }
+            return std::size_t(result);
         }
-        return simd<T, 2*N> { result };
-    #endif
+    }
+    scl_profile_count(to_bitfield_loop);
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+         result |= std::uint64_t(mask.data[i] != 0) << i;
+    }
+    return std::size_t(result);
 }
 
-/*-----------------------------*/
-/* Logical and State Functions */
-/*-----------------------------*/
+/* Convert integer bitfield to boolean vector. */
+template<typename T, std::size_t N>
+constexpr sf_inline typename simd<T, N>::mask_type
+to_mask(std::size_t bitfield) {
+    static_assert(N <= 64, "to_mask supports at most 64 lanes");
+    using element_type = typename simd<T, N>::mask_element_type;
+    typename simd<T, N>::mask_type result;
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = (std::uint64_t(bitfield) >> i) & 1 ? element_type(~0) 
+                                                             : element_type(0);
+    }
+    return result;
+}
+
+/* Bitfield with one bit for each of the N lanes. */
+template<std::size_t N>
+inline constexpr std::uint64_t all_lanes = N >= 64 ? ~std::uint64_t(0) 
+                                                   : (std::uint64_t(1) << N) - 1;
 
 /* Returns true if all bits are 1. */
 template<typename T, std::size_t N>
 constexpr sf_inline bool
 horizontal_and(const typename simd<T, N>::mask_type& mask) {
-    bool result = true;
-    for (std::size_t i = 0; i < N; ++i) {
-         result &= mask.data[i];
+    if constexpr (N <= 64) {
+        return to_bitfield<T, N>(mask) == all_lanes<N>;
+    } else {
+        bool result = true;
+        for (std::size_t i = 0; i < N; ++i) {
+             result &= mask.data[i] != 0;
+        }
+        return result;
     }
-    return result;
 }
 
 /* Returns true if any bit is 1. */
 template<typename T, std::size_t N>
 constexpr sf_inline bool
 horizontal_or(const typename simd<T, N>::mask_type& mask) {
-    bool result = false;
-    for (std::size_t i = 0; i < N; ++i) {
-         result |= mask.data[i];
+    if constexpr (N <= 64) {
+        return to_bitfield<T, N>(mask) != 0;
+    } else {
+        return bool(mask);
     }
-    return result;
 }
 
 /* Returns true if all bits are 0. */
 template<typename T, std::size_t N>
 constexpr sf_inline bool
 horizontal_not(const typename simd<T, N>::mask_type& mask) {
-    bool result = true;
+    return !horizontal_or<T, N>(mask);
+}
+
+/* Mask with the first n lanes set, used to drive masked loop tails. */
+template<typename T, std::size_t N>
+constexpr sf_inline typename simd<T, N>::mask_type
+first_n(std::size_t n) {
+    using element_type = typename simd<T, N>::mask_element_type;
+    typename simd<T, N>::mask_type result;
     for (std::size_t i = 0; i < N; ++i) {
-         result &= !mask.data[i];
+         result.data[i] = (i < n) ? element_type(~0) : element_type(0);
     }
     return result;
 }
 
-/* Convert boolean vector to integer bitfield. */
+/* Number of set lanes. */
 template<typename T, std::size_t N>
 constexpr sf_inline std::size_t
-to_bitfield(const typename simd<T, N>::mask_type& mask) {
-    std::size_t result = 0;
-    for (std::size_t i = 0; i < N; ++i) {
-         result |= (mask.data[i] ? 1 : 0) << i;
+popcount(const typename simd<T, N>::mask_type& mask) {
+    if constexpr (N <= 64) {
+        return std::size_t(std::popcount(std::uint64_t(to_bitfield<T, N>(mask))));
+    } else {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+             count += mask.data[i] != 0;
+        }
+        return count;
     }
-    return result;
 }
 
-/* Convert integer bitfield to boolean vector. */
+/* Index of the first set lane, or N if no lane is set. */
 template<typename T, std::size_t N>
-constexpr sf_inline typename simd<T, N>::mask_type
-to_mask(std::size_t bitfield) {
-    typename simd<T, N>::mask_type result;
+constexpr sf_inline std::size_t
+find_first_set(const typename simd<T, N>::mask_type& mask) {
+    if constexpr (N <= 64) {
+        const std::uint64_t bits = to_bitfield<T, N>(mask);
+        return bits ? std::size_t(std::countr_zero(bits)) : N;
+    } else {
+        for (std::size_t i = 0; i < N; ++i) {
+            if (mask.data[i] != 0) {
+                return i;
+            }
+        }
+        return N;
+    }
+}
+
+/* Index of the last set lane, or N if no lane is set. */
+template<typename T, std::size_t N>
+constexpr sf_inline std::size_t
+find_last_set(const typename simd<T, N>::mask_type& mask) {
+    if constexpr (N <= 64) {
+        const std::uint64_t bits = to_bitfield<T, N>(mask);
+        return bits ? std::size_t(63 - std::countl_zero(bits)) : N;
+    } else {
+        for (std::size_t i = N; i-- > 0;) {
+            if (mask.data[i] != 0) {
+                return i;
+            }
+        }
+        return N;
+    }
+}
+
+/*------------------*/
+/* Mask Compression */
+/*------------------*/
+
+namespace detail {
+
+/* permutevar8x32 indices that move the set lanes of an 8-bit mask to */
+/* the front, one nibble per destination lane.                        */
+inline constexpr auto compress_indices_8x32 = [] {
+    std::array<std::uint32_t, 256> table {};
+    for (std::uint32_t bits = 0; bits < 256; ++bits) {
+        std::uint32_t entry = 0;
+        std::uint32_t k     = 0;
+        for (std::uint32_t i = 0; i < 8; ++i) {
+            if (bits >> i & 1) {
+                entry |= i << (4 * k++);
+            }
+        }
+        table[bits] = entry;
+    }
+    return table;
+}();
+
+/* Scalar compress. Every lane is written to slot k, which only advances */
+/* past lanes that are set, so the active lanes end up packed in order.  */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+compress_lanes(const simd<T, N>& v, const typename simd<T, N>::mask_type& mask) {
+    simd<T, N>  result;
+    std::size_t k = 0;
     for (std::size_t i = 0; i < N; ++i) {
-         result.data[i] = (bitfield & (1 << i)) != 0;
+         result.data[k] = v.data[i];
+         k += mask.data[i] != 0;
+    }
+    for (std::size_t i = k; i < N; ++i) {
+         result.data[i] = T(0);
     }
     return result;
 }
 
+} /* namespace detail */
+
+/* Pack the lanes of v whose mask is set into the lowest lanes, in order, */
+/* and zero the rest, as AVX-512 vpcompress does. AVX-512F/VL handles     */
+/* 32- and 64-bit lanes, VBMI2 adds 8- and 16-bit lanes, and AVX2 uses a  */
+/* table-driven permute for eight 32-bit lanes; other shapes use a        */
+/* branchless scalar loop.                                                */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+compress(const simd<T, N>& v, const typename simd<T, N>::mask_type& mask) {
+    if (std::is_constant_evaluated()) {
+        return detail::compress_lanes(v, mask);
+    }
+    scl_profile_lanes(compress, profile::active_lanes(mask, N), N);
+    constexpr std::size_t bytes = sizeof(T) * N;
+    sf_unused_parameter(bytes);
+
+    simd<T, N> result;
+    sf_unused_parameter(result);
+    #if defined(SF_ISA_AVX2)
+    /* Only the shapes below use bits, and they all have at most 64 lanes. */
+    std::size_t bits = 0;
+    if constexpr (N <= 64) {
+        bits = to_bitfield<T, N>(mask);
+    }
+    sf_unused_parameter(bits);
+    #endif
+    #if defined(SF_ISA_AVX512F)
+    if constexpr (bytes == 64 && sizeof(T) == 4) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_compress_epi32(__mmask16(bits), 
+                                                  std::bit_cast<__m512i>(v.data)));
+        return result;
+    } else if constexpr (bytes == 64 && sizeof(T) == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_compress_epi64(__mmask8(bits), 
+                                                  std::bit_cast<__m512i>(v.data)));
+        return result;
+    }
+    #if defined(__AVX512VL__)
+    if constexpr (bytes == 32 && sizeof(T) == 4) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_maskz_compress_epi32(__mmask8(bits), 
+                                                  std::bit_cast<__m256i>(v.data)));
+        return result;
+    } else if constexpr (bytes == 32 && sizeof(T) == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_maskz_compress_epi64(__mmask8(bits), 
+                                                  std::bit_cast<__m256i>(v.data)));
+        return result;
+    } else if constexpr (bytes == 16 && sizeof(T) == 4) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm_maskz_compress_epi32(__mmask8(bits), 
+                                               std::bit_cast<__m128i>(v.data)));
+        return result;
+    } else if constexpr (bytes == 16 && sizeof(T) == 8) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm_maskz_compress_epi64(__mmask8(bits), 
+                                               std::bit_cast<__m128i>(v.data)));
+        return result;
+    }
+    #endif
+    #if defined(__AVX512VBMI2__)
+    if constexpr (bytes == 64 && sizeof(T) == 1) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_compress_epi8(__mmask64(bits), 
+                                                 std::bit_cast<__m512i>(v.data)));
+        return result;
+    } else if constexpr (bytes == 64 && sizeof(T) == 2) {
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm512_maskz_compress_epi16(__mmask32(bits), 
+                                                  std::bit_cast<__m512i>(v.data)));
+        return result;
+    }
+    #endif
+    #endif
+    #if defined(SF_ISA_AVX2)
+    if constexpr (bytes == 32 && sizeof(T) == 4) {
+        const __m256i     shift = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i     index = _mm256_and_si256(
+                                  _mm256_srlv_epi32(
+                                  _mm256_set1_epi32(int(detail::compress_indices_8x32[bits])),
+                                  shift), _mm256_set1_epi32(0xF));
+        const __m256i     keep  = _mm256_cmpgt_epi32(
+                                  _mm256_set1_epi32(std::popcount(bits)),
+                                  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        result.data = std::bit_cast<decltype(result.data)>(
+                      _mm256_and_si256(_mm256_permutevar8x32_epi32(
+                                       std::bit_cast<__m256i>(v.data), index), keep));
+        return result;
+    }
+    #endif
+
+    scl_profile_count(compress_loop);
+    return detail::compress_lanes(v, mask);
+}
+
+/* Store the lanes of v whose mask is set contiguously to ptr and return */
+/* how many were stored. Exactly that many elements are written.         */
+template<typename T, std::size_t N>
+constexpr sf_inline std::size_t
+compress_store(T* ptr, const simd<T, N>& v, const typename simd<T, N>::mask_type& mask) {
+    const std::size_t count = popcount<T, N>(mask);
+    compress(v, mask).store_partial(ptr, count);
+    return count;
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
 } /* namespace scl */
 } /* namespace sf */
@@ -0,0 +1,648 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Algorithms over Spans                                 */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Vectorized counterparts of the <algorithm> and <numeric> loops that every  */
+/* simd user ends up writing by hand. Each takes a std::span and a generic    */
+/* callable over simd<T, N>, and handles the blocking itself:                 */
+/*                                                                            */
+/*     scl::transform(std::span(in), std::span(out),                          */
+/*                    [](auto v) { return v * v; });                          */
+/*                                                                            */
+/*     float dot = scl::transform_reduce(std::span(a), std::span(b), 0.0f);   */
+/*                                                                            */
+/* N defaults to native_width<T>. Full blocks are plain vector loads and      */
+/* stores, with a masked block for the tail, so the callable only ever sees   */
+/* simd<T, N>; inactive tail lanes are zero on input and discarded on output. */
+/* Where stores (transform) or loads (reductions) benefit from alignment, the */
+/* unaligned head is peeled off as another masked block first. Reductions     */
+/* keep several independent accumulators so that a chain of adds or FMAs is   */
+/* not bound by their latency.                                                */
+/*                                                                            */
+/* As with std::reduce, reduction operations must be associative and         */
+/* commutative, since lanes and blocks are combined in an unspecified order.  */
+/* Floating-point sums will therefore differ in the last bits from a         */
+/* sequential loop.                                                           */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+namespace detail {
+
+/*---------------------*/
+/* Blocking Parameters */
+/*---------------------*/
+
+/* Block width for an algorithm; N = 0 selects native_width<T>. */
+template<std::size_t N, typename T>
+inline constexpr std::size_t algorithm_width = N ? N : native_width<T>;
+
+/* Independent accumulators per reduction. Eight registers' worth covers */
+/* the latency-throughput product of FMA on current x86 and AArch64      */
+/* cores; vectors wider than a register get proportionally fewer so the  */
+/* accumulators alone never exceed eight registers.                      */
+template<typename T, std::size_t N>
+inline constexpr std::size_t accumulators =
+8 * SF_ISA_VECTOR_BYTES / (sizeof(T) * N) < 1 ? 1 :
+8 * SF_ISA_VECTOR_BYTES / (sizeof(T) * N) > 8 ? 8 :
+8 * SF_ISA_VECTOR_BYTES / (sizeof(T) * N);
+
+/* True when consecutive blocks stay aligned once the first one is. */
+template<typename T, std::size_t N>
+inline constexpr bool aligned_stride =
+(sizeof(T) * N) % simd<T, N>::alignment == 0;
+
+/* Elements before ptr reaches simd<T, N>::alignment, at most n. */
+template<typename T, std::size_t N>
+sf_inline std::size_t
+peel_count(const T* ptr, std::size_t n) {
+    if constexpr (!aligned_stride<T, N>) {
+        return 0;
+    } else {
+        constexpr std::size_t alignment = simd<T, N>::alignment;
+        const std::uintptr_t  address   = reinterpret_cast<std::uintptr_t>(ptr);
+        if (address % sizeof(T) != 0) {
+            return 0;
+        }
+        const std::size_t head = (alignment - address % alignment) % alignment /
+                                 sizeof(T);
+        return head < n ? head : n;
+    }
+}
+
+/* Returns true if ptr meets simd<T, N>::alignment and every later block */
+/* will as well.                                                        */
+template<typename T, std::size_t N>
+sf_inline bool
+is_aligned(const T* ptr) {
+    return aligned_stride<T, N> &&
+           reinterpret_cast<std::uintptr_t>(ptr) % simd<T, N>::alignment == 0;
+}
+
+/* Aligned selects the aligned load and store forms; callers pass the */
+/* result of is_aligned as std::true_type or std::false_type.          */
+template<typename T, std::size_t N, bool Aligned>
+sf_inline simd<T, N>
+load_block(const T* ptr) {
+    simd<T, N> v;
+    if constexpr (Aligned) {
+        v.load_aligned(ptr);
+    } else {
+        v.load(ptr);
+    }
+    return v;
+}
+
+template<typename T, std::size_t N, bool Aligned>
+sf_inline void
+store_block(T* ptr, const simd<T, N>& v) {
+    if constexpr (Aligned) {
+        v.store_aligned(ptr);
+    } else {
+        v.store(ptr);
+    }
+}
+
+template<typename T, std::size_t N>
+sf_inline simd<T, N>
+load_partial_block(const T* ptr, std::size_t count) {
+    simd<T, N> v;
+    v.load_partial(ptr, count);
+    return v;
+}
+
+/* Apply a vector operation to two scalars through one-lane vectors. */
+template<typename T, typename Op>
+sf_inline T
+apply_scalar(Op& op, T a, T b) {
+    return simd<T, 1>(op(simd<T, 1>(a), simd<T, 1>(b)))[0];
+}
+
+/* Combine the lanes of v with op, as a tree when N is even. */
+template<typename T, std::size_t N, typename Op>
+sf_inline T
+fold_lanes(const simd<T, N>& v, Op& op) {
+    if constexpr (N == 1) {
+        return v[0];
+    } else if constexpr (N % 2 == 0) {
+        return fold_lanes(simd<T, N/2>(op(v.template get_low<N/2>(),
+                                          v.template get_high<N/2>())), op);
+    } else {
+        T result = v[0];
+        for (std::size_t i = 1; i < N; ++i) {
+             result = apply_scalar(op, result, v[i]);
+        }
+        return result;
+    }
+}
+
+/*------------------*/
+/* Reduction Engine */
+/*------------------*/
+
+template<typename T, std::size_t N, bool Aligned,
+         typename First, typename Step, typename Partial, typename Op>
+sf_inline T
+reduce_aligned_blocks(std::size_t n, std::size_t head, std::bool_constant<Aligned> a,
+                      T init, First& first, Step& step, Partial& partial, Op& op) {
+    using V = simd<T, N>;
+    constexpr std::size_t K = accumulators<T, N>;
+
+    if (n < N) {
+        T result = init;
+        if (n > 0) {
+            const V v = partial(0, n);
+            for (std::size_t i = 0; i < n; ++i) {
+                 result = apply_scalar(op, result, v[i]);
+            }
+        }
+        return result;
+    }
+    std::array<V, K> acc {};
+    std::size_t      i    = head;
+    std::size_t      used = 1;
+    acc[0] = first(i, a);
+    for (i += N; used < K && i + N <= n; ++used, i += N) {
+         acc[used] = first(i, a);
+    }
+    for (; i + K * N <= n; i += K * N) {
+        sf_unroll(8)
+        for (std::size_t k = 0; k < K; ++k) {
+             acc[k] = step(acc[k], i + k * N, a);
+        }
+    }
+    for (; i + N <= n; i += N) {
+         acc[0] = step(acc[0], i, a);
+    }
+    if (i < n) {
+        acc[0] = select<T, N>(first_n<T, N>(n - i),
+                              V(op(acc[0], partial(i, n - i))), acc[0]);
+    }
+    if (head > 0) {
+        acc[0] = select<T, N>(first_n<T, N>(head),
+                              V(op(acc[0], partial(0, head))), acc[0]);
+    }
+    for (std::size_t k = 1; k < used; ++k) {
+         acc[0] = op(acc[0], acc[k]);
+    }
+    return apply_scalar(op, init, fold_lanes(acc[0], op));
+}
+
+/* Reduces n elements, viewed as blocks through three callables:         */
+/*                                                                       */
+/*     first(i, a)     - the block at i, as the initial accumulator      */
+/*     step(acc, i, a) - acc with the block at i folded in               */
+/*     partial(i, c)   - the c-element masked block at i                 */
+/*                                                                       */
+/* Full blocks start after the first head elements, which the caller    */
+/* chose so that the leading input is aligned there. a tells first and  */
+/* step whether it is, as std::true_type or std::false_type.            */
+template<typename T, std::size_t N,
+         typename First, typename Step, typename Partial, typename Op>
+sf_inline T
+reduce_blocks(std::size_t n, std::size_t head, bool aligned, T init,
+              First first, Step step, Partial partial, Op op) {
+    if (n >= N && n - head < N) {
+        head    = 0;
+        aligned = false;
+    }
+    if (aligned) {
+        return reduce_aligned_blocks<T, N>(n, head, std::true_type{}, init,
+                                           first, step, partial, op);
+    }
+    return reduce_aligned_blocks<T, N>(n, head, std::false_type{}, init,
+                                       first, step, partial, op);
+}
+
+/* Inclusive scan of one block: after step S, lane i holds the fold of */
+/* lanes [i - 2S + 1, i].                                              */
+template<std::size_t S, typename T, std::size_t N, typename Op>
+sf_inline simd<T, N>
+scan_block(const simd<T, N>& v, Op& op) {
+    if constexpr (S >= N) {
+        return v;
+    } else {
+        /* The zeros slid into the lowest S lanes are discarded by select, */
+        /* so op needs no identity element.                                */
+        const simd<T, N> shifted = slide_up<S>(v);
+        const simd<T, N> next    = select<T, N>(~first_n<T, N>(S),
+                                                simd<T, N>(op(shifted, v)), v);
+        return scan_block<2 * S>(next, op);
+    }
+}
+
+/* Number of set lanes among the first count lanes of mask. */
+template<typename T, std::size_t N>
+sf_inline std::size_t
+count_lanes(const typename simd<T, N>::mask_type& mask, std::size_t count = N) {
+    if constexpr (N <= 64) {
+        return popcount<T, N>(count < N ? mask & first_n<T, N>(count) : mask);
+    } else {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+             result += mask.data[i] != 0;
+        }
+        return result;
+    }
+}
+
+} /* namespace detail */
+
+/*-----------*/
+/* Transform */
+/*-----------*/
+
+/* out[i] = f(in[i]), N elements at a time. f maps simd<T, N> to a      */
+/* simd<U, N>. out must hold at least in.size() elements; the two may   */
+/* be the same span.                                                     */
+template<std::size_t N = 0, typename T, std::size_t E1,
+                            typename U, std::size_t E2, typename F>
+void
+transform(std::span<T, E1> in, std::span<U, E2> out, F f) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    const std::size_t n    = in.size();
+    const VT*         src  = in.data();
+    U*                dst  = out.data();
+    const std::size_t head = n >= W ? detail::peel_count<U, W>(dst, n) : 0;
+
+    if (head > 0) {
+        simd<U, W>(f(detail::load_partial_block<VT, W>(src, head)))
+            .store_partial(dst, head);
+    }
+    const auto blocks = [&](auto aligned) {
+        std::size_t i = head;
+        for (; i + W <= n; i += W) {
+             detail::store_block<U, W, decltype(aligned)::value>(dst + i, 
+                 simd<U, W>(f(detail::load_block<VT, W, false>(src + i))));
+        }
+        return i;
+    };
+    const std::size_t i = detail::is_aligned<U, W>(dst + head) 
+                        ? blocks(std::true_type{}) : blocks(std::false_type{});
+    if (i < n) {
+        simd<U, W>(f(detail::load_partial_block<VT, W>(src + i, n - i)))
+            .store_partial(dst + i, n - i);
+    }
+}
+
+/* out[i] = f(a[i], b[i]). b and out must hold at least a.size() elements. */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2,
+                            typename U,  std::size_t E3, typename F>
+void
+transform(std::span<T1, E1> a, std::span<T2, E2> b, std::span<U, E3> out, F f) {
+    using V1 = std::remove_cv_t<T1>;
+    using V2 = std::remove_cv_t<T2>;
+    constexpr std::size_t W = detail::algorithm_width<N, V1>;
+    const std::size_t n    = a.size();
+    const V1*         x    = a.data();
+    const V2*         y    = b.data();
+    U*                dst  = out.data();
+    const std::size_t head = n >= W ? detail::peel_count<U, W>(dst, n) : 0;
+
+    if (head > 0) {
+        simd<U, W>(f(detail::load_partial_block<V1, W>(x, head),
+                     detail::load_partial_block<V2, W>(y, head)))
+            .store_partial(dst, head);
+    }
+    const auto blocks = [&](auto aligned) {
+        std::size_t i = head;
+        for (; i + W <= n; i += W) {
+             detail::store_block<U, W, decltype(aligned)::value>(dst + i, 
+                 simd<U, W>(f(detail::load_block<V1, W, false>(x + i),
+                              detail::load_block<V2, W, false>(y + i))));
+        }
+        return i;
+    };
+    const std::size_t i = detail::is_aligned<U, W>(dst + head) 
+                        ? blocks(std::true_type{}) : blocks(std::false_type{});
+    if (i < n) {
+        simd<U, W>(f(detail::load_partial_block<V1, W>(x + i, n - i),
+                     detail::load_partial_block<V2, W>(y + i, n - i)))
+            .store_partial(dst + i, n - i);
+    }
+}
+
+/*------------*/
+/* Reductions */
+/*------------*/
+
+/* Fold every element into init with op, which combines two simd<T, N>. */
+template<std::size_t N = 0, typename T, std::size_t E, typename Op>
+std::remove_cv_t<T>
+reduce(std::span<T, E> in, std::remove_cv_t<T> init, Op op) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    const VT*         src  = in.data();
+    const std::size_t head = detail::peel_count<VT, W>(src, in.size());
+
+    return detail::reduce_blocks<VT, W>(in.size(), head, 
+        detail::is_aligned<VT, W>(src + head), init,
+        [&](std::size_t i, auto aligned) {
+            return detail::load_block<VT, W, decltype(aligned)::value>(src + i);
+        },
+        [&](const simd<VT, W>& acc, std::size_t i, auto aligned) {
+            return simd<VT, W>(op(acc, detail::load_block<VT, W, decltype(aligned)::value>(src + i)));
+        },
+        [&](std::size_t i, std::size_t count) {
+            return detail::load_partial_block<VT, W>(src + i, count);
+        }, op);
+}
+
+/* Sum of all elements. */
+template<std::size_t N = 0, typename T, std::size_t E>
+std::remove_cv_t<T>
+reduce(std::span<T, E> in) {
+    return scl::reduce<N>(in, std::remove_cv_t<T>{}, std::plus<>{});
+}
+
+/* Fold transform_op(in[i]) into init with reduce_op. */
+template<std::size_t N = 0, typename T, std::size_t E, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(std::span<T, E> in, R init,
+                 ReduceOp reduce_op, TransformOp transform_op) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    const VT*         src  = in.data();
+    const std::size_t head = detail::peel_count<VT, W>(src, in.size());
+
+    return detail::reduce_blocks<R, W>(in.size(), head, 
+        detail::is_aligned<VT, W>(src + head), init,
+        [&](std::size_t i, auto aligned) {
+            return simd<R, W>(transform_op(
+                   detail::load_block<VT, W, decltype(aligned)::value>(src + i)));
+        },
+        [&](const simd<R, W>& acc, std::size_t i, auto aligned) {
+            return simd<R, W>(reduce_op(acc, transform_op(
+                   detail::load_block<VT, W, decltype(aligned)::value>(src + i))));
+        },
+        [&](std::size_t i, std::size_t count) {
+            return simd<R, W>(transform_op(
+                   detail::load_partial_block<VT, W>(src + i, count)));
+        }, reduce_op);
+}
+
+/* Fold transform_op(a[i], b[i]) into init with reduce_op. b must hold */
+/* at least a.size() elements.                                         */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(std::span<T1, E1> a, std::span<T2, E2> b, R init,
+                 ReduceOp reduce_op, TransformOp transform_op) {
+    using V1 = std::remove_cv_t<T1>;
+    using V2 = std::remove_cv_t<T2>;
+    constexpr std::size_t W = detail::algorithm_width<N, V1>;
+    const V1*         x    = a.data();
+    const V2*         y    = b.data();
+    const std::size_t head = detail::peel_count<V1, W>(x, a.size());
+
+    return detail::reduce_blocks<R, W>(a.size(), head, 
+        detail::is_aligned<V1, W>(x + head), init,
+        [&](std::size_t i, auto aligned) {
+            return simd<R, W>(transform_op(
+                   detail::load_block<V1, W, decltype(aligned)::value>(x + i),
+                   detail::load_block<V2, W, false>(y + i)));
+        },
+        [&](const simd<R, W>& acc, std::size_t i, auto aligned) {
+            return simd<R, W>(reduce_op(acc, transform_op(
+                   detail::load_block<V1, W, decltype(aligned)::value>(x + i),
+                   detail::load_block<V2, W, false>(y + i))));
+        },
+        [&](std::size_t i, std::size_t count) {
+            return simd<R, W>(transform_op(
+                   detail::load_partial_block<V1, W>(x + i, count),
+                   detail::load_partial_block<V2, W>(y + i, count)));
+        }, reduce_op);
+}
+
+/* Inner product of a and b plus init. Each block is a single fma into  */
+/* its accumulator, which is where the independent accumulators matter. */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R>
+R
+transform_reduce(std::span<T1, E1> a, std::span<T2, E2> b, R init) {
+    static_assert(std::is_same<std::remove_cv_t<T1>, R>::value &&
+                  std::is_same<std::remove_cv_t<T2>, R>::value,
+                  "transform_reduce(a, b, init) requires one element type");
+    constexpr std::size_t W = detail::algorithm_width<N, R>;
+    const R*          x    = a.data();
+    const R*          y    = b.data();
+    const std::size_t head = detail::peel_count<R, W>(x, a.size());
+
+    return detail::reduce_blocks<R, W>(a.size(), head, 
+        detail::is_aligned<R, W>(x + head), init,
+        [&](std::size_t i, auto aligned) {
+            return detail::load_block<R, W, decltype(aligned)::value>(x + i) *
+                   detail::load_block<R, W, false>(y + i);
+        },
+        [&](const simd<R, W>& acc, std::size_t i, auto aligned) {
+            return fma(detail::load_block<R, W, decltype(aligned)::value>(x + i),
+                       detail::load_block<R, W, false>(y + i), acc);
+        },
+        [&](std::size_t i, std::size_t count) {
+            return detail::load_partial_block<R, W>(x + i, count) *
+                   detail::load_partial_block<R, W>(y + i, count);
+        }, std::plus<>{});
+}
+
+/*------*/
+/* Scan */
+/*------*/
+
+/* out[i] = in[0] op in[1] op ... op in[i]. Each block is scanned in     */
+/* log2(N) shift-and-combine steps and then offset by the running total. */
+template<std::size_t N = 0, typename T, std::size_t E1,
+                            typename U, std::size_t E2, typename Op = std::plus<>>
+void
+inclusive_scan(std::span<T, E1> in, std::span<U, E2> out, Op op = {}) {
+    using VT = std::remove_cv_t<T>;
+    static_assert(std::is_same<VT, U>::value,
+                  "inclusive_scan requires matching input and output types");
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    using V = simd<VT, W>;
+
+    const std::size_t n   = in.size();
+    const VT*         src = in.data();
+    U*                dst = out.data();
+
+    V           carry;
+    std::size_t i = 0;
+    for (; i < n; i += W) {
+        const std::size_t count = n - i < W ? n - i : W;
+        V v = count == W ? detail::load_block<VT, W, false>(src + i)
+                         : detail::load_partial_block<VT, W>(src + i, count);
+        v = detail::scan_block<1>(v, op);
+        if (i > 0) {
+            v = op(carry, v);
+        }
+        if (count == W) {
+            v.store(dst + i);
+        } else {
+            v.store_partial(dst + i, count);
+        }
+        carry = V(v[W - 1]);
+    }
+}
+
+/*-----------*/
+/* Filtering */
+/*-----------*/
+
+/* FIR filter over the outputs that have an input for every tap:       */
+/*                                                                     */
+/*     out[i] = taps[0] * in[i + K - 1] + ... + taps[K - 1] * in[i]    */
+/*                                                                     */
+/* for K = taps.size() and i < in.size() - K + 1, which is returned.   */
+/* To filter a stream in chunks, start each chunk with the last K - 1  */
+/* inputs of the one before. Each tap is broadcast once per group of   */
+/* output blocks and combined with the input window starting at that   */
+/* tap, an overlapping unaligned load; the groups keep as many         */
+/* independent accumulators as the reductions do.                      */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2,
+                            typename U,  std::size_t E3>
+std::size_t
+convolve(std::span<T1, E1> in, std::span<T2, E2> taps, std::span<U, E3> out) {
+    using VT = std::remove_cv_t<T1>;
+    static_assert(std::is_same<VT, std::remove_cv_t<T2>>::value && std::is_same<VT, U>::value,
+                  "convolve requires matching input, tap and output types");
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    constexpr std::size_t A = detail::accumulators<VT, W>;
+    using V = simd<VT, W>;
+
+    const std::size_t k = taps.size();
+    const std::size_t n = in.size();
+    if (k == 0 || n < k) {
+        return 0;
+    }
+    const std::size_t count = n - k + 1;
+    const VT*         src   = in.data();
+    const VT*         h     = taps.data();
+    U*                dst   = out.data();
+
+    std::size_t i = 0;
+    for (; i + A * W <= count; i += A * W) {
+        std::array<V, A> acc {};
+        for (std::size_t j = 0; j < k; ++j) {
+            const V tap(h[k - 1 - j]);
+            sf_unroll(8)
+            for (std::size_t a = 0; a < A; ++a) {
+                 acc[a] = fma(tap, detail::load_block<VT, W, false>(src + i + a * W + j), acc[a]);
+            }
+        }
+        sf_unroll(8)
+        for (std::size_t a = 0; a < A; ++a) {
+             acc[a].store(dst + i + a * W);
+        }
+    }
+    for (; i < count; i += W) {
+        const std::size_t lanes = count - i < W ? count - i : W;
+        V acc(VT(0));
+        for (std::size_t j = 0; j < k; ++j) {
+            /* The window of the last, partial block ends at in[n - 1]. */
+            const V window = lanes == W ? detail::load_block<VT, W, false>(src + i + j)
+                                        : detail::load_partial_block<VT, W>(src + i + j, lanes);
+            acc = fma(V(h[k - 1 - j]), window, acc);
+        }
+        acc.store_partial(dst + i, lanes);
+    }
+    return count;
+}
+
+/*------------------------*/
+/* Searching and Counting */
+/*------------------------*/
+
+/* Number of elements for which pred, a simd<T, N> -> mask_type, is set. */
+template<std::size_t N = 0, typename T, std::size_t E, typename Pred>
+std::size_t
+count_if(std::span<T, E> in, Pred pred) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    const std::size_t n      = in.size();
+    const VT*         src    = in.data();
+    std::size_t       result = 0;
+    std::size_t       i      = 0;
+    for (; i + W <= n; i += W) {
+         result += detail::count_lanes<VT, W>(
+                   pred(detail::load_block<VT, W, false>(src + i)));
+    }
+    if (i < n) {
+        result += detail::count_lanes<VT, W>(
+                  pred(detail::load_partial_block<VT, W>(src + i, n - i)), n - i);
+    }
+    return result;
+}
+
+/* Iterator to the first element for which pred is set, or in.end(). */
+template<std::size_t N = 0, typename T, std::size_t E, typename Pred>
+typename std::span<T, E>::iterator
+find_if(std::span<T, E> in, Pred pred) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = detail::algorithm_width<N, VT>;
+    const std::size_t n   = in.size();
+    const VT*         src = in.data();
+
+    /* Index of the first set lane of mask among the first count, or W. */
+    const auto first = [](const auto& mask, std::size_t count) {
+        if constexpr (W <= 64) {
+            const std::size_t j = find_first_set<VT, W>(mask);
+            return j < count ? j : W;
+        } else {
+            if (horizontal_or<VT, W>(mask)) {
+                for (std::size_t j = 0; j < count; ++j) {
+                    if (mask.data[j]) {
+                        return j;
+                    }
+                }
+            }
+            return W;
+        }
+    };
+
+    /* Full blocks are a separate loop, so that the block the predicate */
+    /* sees is a plain load rather than a choice between two sources.   */
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        const std::size_t j = first(pred(detail::load_block<VT, W, false>(src + i)), W);
+        if (j < W) {
+            return in.begin() + (i + j);
+        }
+    }
+    if (i < n) {
+        const std::size_t j = first(pred(detail::load_partial_block<VT, W>(src + i, n - i)),
+                                    n - i);
+        if (j < W) {
+            return in.begin() + (i + j);
+        }
+    }
+    return in.end();
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
@@ -0,0 +1,271 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Runtime Instruction Set Dispatch                      */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* native_width<T> is fixed when the program is compiled. To ship one binary  */
+/* that uses AVX-512 where it exists and still runs on SSE2-only machines,    */
+/* compile one variant of a kernel per instruction set and register them in   */
+/* a function_table, which asks the CPU once what it supports and calls the   */
+/* best variant from then on.                                                 */
+/*                                                                            */
+/* scl picks its intrinsics with the SF_ISA_* macros of sf_base.hpp, which    */
+/* follow the compiler flags of the translation unit. A target attribute on   */
+/* one function does not change them, so scl calls inside an sf_target        */
+/* function still compile to the baseline instructions; only loops the        */
+/* compiler vectorizes itself get wider. Each variant must therefore be       */
+/* built in its own translation unit with the matching flags:                 */
+/*                                                                            */
+/*     // scale.hpp, included by every variant                                */
+/*     template<std::size_t W>                                                */
+/*     void scale_kernel(float* p, std::size_t n, float k) {                  */
+/*         scl::transform<W>(std::span(p, n), std::span(p, n),                */
+/*                           [k](auto x) { return x * k; });                  */
+/*     }                                                                      */
+/*     void scale_sse2(float* p, std::size_t n, float k);                     */
+/*     void scale_avx512(float* p, std::size_t n, float k);                   */
+/*                                                                            */
+/*     // scale_sse2.cpp, built with the baseline flags                       */
+/*     void scale_sse2(float* p, std::size_t n, float k)                      */
+/*     { scale_kernel<dispatch_width<float, isa::sse2>>(p, n, k); }           */
+/*                                                                            */
+/*     // scale_avx512.cpp, built with -march=x86-64-v4 (/arch:AVX512)        */
+/*     void scale_avx512(float* p, std::size_t n, float k)                    */
+/*     { scale_kernel<dispatch_width<float, isa::avx512>>(p, n, k); }         */
+/*                                                                            */
+/*     // scale.cpp, built with the baseline flags                            */
+/*     const function_table<void(float*, std::size_t, float)> scale {         */
+/*         { isa::generic, scale_sse2 }, { isa::avx512, scale_avx512 }        */
+/*     };                                                                     */
+/*                                                                            */
+/* scl's own inline functions and templates need no care: scl.hpp declares    */
+/* them in an inline namespace named after the flags of the translation unit, */
+/* so each variant gets its own copy of scl::transform and the linker cannot  */
+/* substitute one for another. That does not extend to the caller's code.     */
+/* scale_kernel above is instantiated with a different W in each variant; an  */
+/* inline function or template of the caller's that is instantiated the same  */
+/* way in two variants is still merged, and must be given internal linkage    */
+/* (static or an unnamed namespace) or be kept out of the variants. scl types */
+/* are distinct in each variant, so only plain types should cross between the */
+/* entry points.                                                              */
+/*                                                                            */
+/* isa, host_supports and function_table are shared by all variants, so a     */
+/* table can be declared in a header that every variant includes.             */
+/*                                                                            */
+/* Since a target attribute leaves the SF_ISA_* macros unchanged, sf_target,  */
+/* the sf_target_avx2 family below and sf_target_clones only help code that   */
+/* does not go through scl. They expand to nothing on MSVC, where every       */
+/* function they mark is baseline code.                                       */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+/* Platform Includes */
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+#endif
+#if defined(__linux__) && defined(__aarch64__)
+    #include <sys/auxv.h>
+#endif
+
+/* Target strings for the x86 and AArch64 dispatch levels below. */
+#if defined(__clang__) && defined(__aarch64__)
+   #define sf_target_sve       sf_target("sve")
+#else
+   #define sf_target_sve       sf_target("+sve")
+#endif
+#define sf_target_avx2         sf_target("avx2,fma")
+#define sf_target_avx512       sf_target("avx512f,avx512bw,avx512dq,avx512vl")
+
+namespace sf  {
+namespace scl {
+
+/* Dispatch levels, ordered so that a higher value is preferred whenever the */
+/* host supports it. avx2 includes FMA and avx512 is the F/BW/DQ/VL subset   */
+/* present on every AVX-512 CPU, matching x86-64-v3 and -v4.                 */
+enum class isa : std::uint8_t {
+    generic,
+    sse2,
+    avx2,
+    avx512,
+    neon,
+    sve
+};
+
+/* Register width in bytes that kernels written for level should assume. */
+/* SVE is length-agnostic, so its variant is sized for the 128-bit       */
+/* minimum and gains predication and gathers rather than wider lanes.    */
+constexpr std::size_t
+vector_bytes(isa level) {
+    switch (level) {
+        case isa::avx2:   return 32;
+        case isa::avx512: return 64;
+        default:          return 16;
+    }
+}
+
+/* Lanes of T in one register at the given level. */
+template<typename T, isa Level>
+inline constexpr std::size_t dispatch_width =
+vector_bytes(Level) / sizeof(T) > 0 ? vector_bytes(Level) / sizeof(T) : 1;
+
+/* Returns true if the running CPU and OS can execute code for level. The */
+/* levels are queried once. The OS must also save the wider register      */
+/* state, which both query paths check: GCC and Clang's                   */
+/* __builtin_cpu_supports internally, MSVC's through XGETBV.              */
+inline bool
+host_supports(isa level) {
+    static const std::uint32_t features = [] {
+        std::uint32_t bits = 1u << static_cast<int>(isa::generic);
+        const auto set = [&](isa supported) {
+            bits |= 1u << static_cast<int>(supported);
+        };
+
+        #if (defined(__GNUC__) || defined(__clang__)) && \
+            (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("sse2")) {
+                set(isa::sse2);
+            }
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                set(isa::avx2);
+            }
+            if (__builtin_cpu_supports("avx512f")  &&
+                __builtin_cpu_supports("avx512bw") &&
+                __builtin_cpu_supports("avx512dq") &&
+                __builtin_cpu_supports("avx512vl")) {
+                set(isa::avx512);
+            }
+        #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            int leaf1[4];
+            int leaf7[4];
+            __cpuidex(leaf1, 1, 0);
+            __cpuidex(leaf7, 7, 0);
+            const bool osxsave = (leaf1[2] >> 27) & 1;
+            const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+            const bool ymm_state = (xcr0 & 0x06) == 0x06;
+            const bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+            if ((leaf1[3] >> 26) & 1) {
+                set(isa::sse2);
+            }
+            if (ymm_state && ((leaf7[1] >> 5) & 1) && ((leaf1[2] >> 12) & 1)) {
+                set(isa::avx2);
+            }
+            /* AVX-512 F (16), DQ (17), BW (30) and VL (31). */
+            const std::uint32_t avx512_bits = (1u << 16) | (1u << 17) |
+                                              (1u << 30) | (1u << 31);
+            if (zmm_state &&
+                (static_cast<std::uint32_t>(leaf7[1]) & avx512_bits) == avx512_bits) {
+                set(isa::avx512);
+            }
+        #endif
+
+        #if defined(__aarch64__) || defined(_M_ARM64)
+            set(isa::neon);
+            #if defined(__linux__)
+                #if !defined(HWCAP_SVE)
+                    #define HWCAP_SVE (1 << 22)
+                #endif
+                if (getauxval(AT_HWCAP) & HWCAP_SVE) {
+                    set(isa::sve);
+                }
+            #endif
+        #elif defined(SF_ISA_NEON)
+            set(isa::neon);
+        #endif
+
+        return bits;
+    }();
+    return (features >> static_cast<int>(level)) & 1u;
+}
+
+/* Highest dispatch level the running CPU supports. */
+inline isa
+host_isa() {
+    isa best = isa::generic;
+    for (isa level : { isa::sse2, isa::avx2, isa::avx512, isa::neon, isa::sve }) {
+        if (host_supports(level)) {
+            best = level;
+        }
+    }
+    return best;
+}
+
+/*------------------------------*/
+/* Runtime-Dispatched Functions */
+/*------------------------------*/
+
+template<typename Signature>
+class function_table;
+
+/* Holds one variant of a function per dispatch level and forwards calls to */
+/* the highest level the host supports. The choice is made once, when the  */
+/* table is constructed, so each call is a single indirect call. Every     */
+/* table must have an isa::generic entry, which is used when no other      */
+/* entry can run; construction asserts that one was given.                 */
+template<typename R, typename... Args>
+class function_table<R(Args...)> {
+public:
+
+    using function_type = R (*)(Args...);
+
+    struct entry {
+        isa           level;
+        function_type function;
+    };
+
+    function_table(std::initializer_list<entry> entries) {
+        bool has_generic = false;
+        for (const entry& e : entries) {
+            has_generic |= e.level == isa::generic && e.function != nullptr;
+            if (e.function != nullptr && host_supports(e.level) &&
+                (selected_function == nullptr || e.level >= selected_level)) {
+                selected_level    = e.level;
+                selected_function = e.function;
+            }
+        }
+        assert(has_generic && "function_table needs an isa::generic entry");
+        sf_unused_parameter(has_generic);
+    }
+
+    R
+    operator()(Args... args) const {
+        return selected_function(std::forward<Args>(args)...);
+    }
+
+    /* The variant that calls are forwarded to. */
+    function_type
+    function() const {
+        return selected_function;
+    }
+
+    /* The dispatch level of that variant. */
+    isa
+    level() const {
+        return selected_level;
+    }
+
+private:
+
+    isa           selected_level    = isa::generic;
+    function_type selected_function = nullptr;
+
+};
+
+} /* namespace scl */
+} /* namespace sf  */
@@ -0,0 +1,279 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Matrix Multiplication                                 */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* C = alpha * A * B + beta * C for row-major float or double matrices, with  */
+/* the BLAS argument order and leading dimensions:                            */
+/*                                                                            */
+/*     scl::gemm(m, n, k, 1.0f, a, k, b, n, 0.0f, c, n);                      */
+/*                                                                            */
+/* simd::dot_product reduces one pair of vectors to a scalar, which costs a   */
+/* horizontal sum per output element. gemm instead keeps an MR x (NR * N)     */
+/* tile of C in MR * NR accumulator registers: each step of k loads NR        */
+/* vectors of a row of B, broadcasts MR elements of a column of A, and issues */
+/* MR * NR independent fma, so loads stay well below one per fma and the fma  */
+/* latency is hidden by the other accumulators. No horizontal operation is    */
+/* needed at all.                                                             */
+/*                                                                            */
+/* The micro-kernel reads A and B from packed panels, in the order it uses    */
+/* them, so that its loads are contiguous and aligned whatever the leading    */
+/* dimensions. gemm packs a gemm_kc-deep slice of B once per slice and a      */
+/* gemm_mc-row block of A once per block, sized so the A block stays in L2    */
+/* while the B slice streams through it. Packing pads edges with zeros; the   */
+/* kernel then masks the rows and columns it writes back, so C is never       */
+/* touched outside m x n.                                                     */
+/*                                                                            */
+/* The default tile uses about three quarters of the vector registers: 6 x 2  */
+/* with 16 registers (SSE2, AVX2) and 12 x 2 with 32 (AVX-512, NEON, SVE,     */
+/* RVV). It is meant for matrices up to a few hundred rows and columns; it is */
+/* single-threaded and does not try to match a tuned BLAS on large problems.  */
+/* As with any blocked product, sums are formed in a different order from the */
+/* naive triple loop and differ from it in the last bits.                     */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/* SCL Includes */
+#include "scl.hpp"
+#include "scl_algorithm.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+/*---------------------*/
+/* Blocking Parameters */
+/*---------------------*/
+
+/* Vector registers of the compile target. */
+#if defined(SF_ISA_AVX512F) || defined(__aarch64__) || \
+    defined(SF_ISA_SVE)     || defined(SF_ISA_RVV)
+inline constexpr std::size_t gemm_registers = 32;
+#else
+inline constexpr std::size_t gemm_registers = 16;
+#endif
+
+/* Rows of A and vectors of B in the default micro-kernel tile. */
+inline constexpr std::size_t gemm_mr = gemm_registers == 32 ? 12 : 6;
+inline constexpr std::size_t gemm_nr = 2;
+
+/* Depth of the packed panels of A and B, and rows of A packed at once. */
+/* gemm_mc is rounded down to a multiple of the tile height.            */
+inline constexpr std::size_t gemm_kc = 256;
+inline constexpr std::size_t gemm_mc = 128;
+
+/*---------*/
+/* Packing */
+/*---------*/
+
+/* Packs rows x k of A into panels of MR rows: element (i, p) of panel q */
+/* is at dst[q * MR * k + p * MR + i]. Rows past the end are zero. dst   */
+/* must hold ceil(rows / MR) * MR * k elements.                          */
+template<std::size_t MR, typename T>
+void
+gemm_pack_a(std::size_t rows, std::size_t k, const T* a, std::size_t lda,
+            T* dst) {
+    for (std::size_t i = 0; i < rows; i += MR) {
+        const std::size_t h = rows - i < MR ? rows - i : MR;
+        for (std::size_t p = 0; p < k; ++p) {
+            for (std::size_t r = 0; r < MR; ++r) {
+                 dst[r] = r < h ? a[(i + r) * lda + p] : T(0);
+            }
+            dst += MR;
+        }
+    }
+}
+
+/* Packs k x cols of B into panels of NR * W columns: element (p, j) of */
+/* panel q is at dst[q * NR * W * k + p * NR * W + j]. Columns past the */
+/* end are zero. dst must be aligned to simd<T, W>::alignment and hold  */
+/* ceil(cols / (NR * W)) * NR * W * k elements. W = 0 selects           */
+/* native_width<T>.                                                     */
+template<std::size_t NR, std::size_t N = 0, typename T>
+void
+gemm_pack_b(std::size_t k, std::size_t cols, const T* b, std::size_t ldb,
+            T* dst) {
+    constexpr std::size_t W = detail::algorithm_width<N, T>;
+    for (std::size_t j = 0; j < cols; j += NR * W) {
+        for (std::size_t p = 0; p < k; ++p) {
+            const T* row = b + p * ldb + j;
+            for (std::size_t v = 0; v < NR; ++v) {
+                 const std::size_t col = j + v * W;
+                 simd<T, W> x;
+                 if (col + W <= cols) {
+                     x.load(row + v * W);
+                 } else {
+                     x.load_partial(row + v * W, col < cols ? cols - col : 0);
+                 }
+                 x.store_aligned(dst + v * W);
+            }
+            dst += NR * W;
+        }
+    }
+}
+
+/*--------------*/
+/* Micro-Kernel */
+/*--------------*/
+
+namespace detail {
+
+/* Accumulator type of the micro-kernel. On GCC the std::array storage of */
+/* simd is kept in memory across loop iterations, so every fma would also */
+/* store its result; a vector-extension local lives in a register. a * b  */
+/* + c on it is contracted to one fma wherever simd's fma would be.       */
+template<typename T, std::size_t W>
+struct gemm_register {
+    #if defined(__GNUC__)
+        typedef T type __attribute__((vector_size(sizeof(T) * W)));
+    #else
+        using type = simd<T, W>;
+    #endif
+};
+
+} /* namespace detail */
+
+/* C = alpha * A * B + beta * C for one MR x (NR * W) tile, where a and b */
+/* point to a packed MR-row panel of A and a packed (NR * W)-column panel */
+/* of B, both k deep. Only the first rows x cols elements of the tile are */
+/* written to C. With beta == 0, C is not read, so it may hold NaN.       */
+template<std::size_t MR, std::size_t NR, std::size_t N = 0, typename T>
+sf_inline void
+gemm_microkernel(std::size_t k, T alpha, const T* a, const T* b, T beta,
+                 T* c, std::size_t ldc, std::size_t rows = MR,
+                 std::size_t cols = NR * detail::algorithm_width<N, T>) {
+    static_assert(std::is_floating_point<T>::value,
+                  "gemm_microkernel requires floating-point elements");
+    constexpr std::size_t W = detail::algorithm_width<N, T>;
+    static_assert(std::has_single_bit(W), 
+                  "gemm_microkernel requires a power-of-two width");
+    using V = simd<T, W>;
+    using R = typename detail::gemm_register<T, W>::type;
+
+    std::array<std::array<R, NR>, MR> acc;
+    sf_unroll(32)
+    for (std::size_t r = 0; r < MR; ++r) {
+        sf_unroll(8)
+        for (std::size_t v = 0; v < NR; ++v) {
+             acc[r][v] = R{};
+        }
+    }
+    for (std::size_t p = 0; p < k; ++p) {
+        std::array<R, NR> bv;
+        sf_unroll(8)
+        for (std::size_t v = 0; v < NR; ++v) {
+             bv[v] = detail::load_chunk<R>(b, sizeof(T) * v * W);
+        }
+        sf_unroll(32)
+        for (std::size_t r = 0; r < MR; ++r) {
+            const R ar = a[r] - R{};
+            sf_unroll(8)
+            for (std::size_t v = 0; v < NR; ++v) {
+                 acc[r][v] = ar * bv[v] + acc[r][v];
+            }
+        }
+        a += MR;
+        b += NR * W;
+    }
+
+    const V va(alpha);
+    const V vb(beta);
+    for (std::size_t r = 0; r < MR && r < rows; ++r) {
+        T* row = c + r * ldc;
+        for (std::size_t v = 0; v < NR && v * W < cols; ++v) {
+            const std::size_t count = cols - v * W < W ? cols - v * W : W;
+            V out;
+            detail::store_chunk(&out.data, 0, acc[r][v]);
+            out *= va;
+            if (count == W) {
+                if (beta != T(0)) {
+                    V old;
+                    old.load(row + v * W);
+                    out = fma(old, vb, out);
+                }
+                out.store(row + v * W);
+            } else {
+                if (beta != T(0)) {
+                    V old;
+                    old.load_partial(row + v * W, count);
+                    out = fma(old, vb, out);
+                }
+                out.store_partial(row + v * W, count);
+            }
+        }
+    }
+}
+
+/*-------------------------*/
+/* General Matrix Multiply */
+/*-------------------------*/
+
+/* C = alpha * A * B + beta * C, where A is m x k, B is k x n and C is   */
+/* m x n, all row-major with leading dimensions lda, ldb and ldc. With   */
+/* beta == 0, C is only written. MR and NR select the micro-kernel tile; */
+/* N = 0 uses native_width<T> lanes.                                     */
+template<std::size_t N = 0, std::size_t MR = gemm_mr, std::size_t NR = gemm_nr,
+         typename T>
+void
+gemm(std::size_t m, std::size_t n, std::size_t k,
+     T alpha, const T* a, std::size_t lda,
+              const T* b, std::size_t ldb,
+     T beta,        T* c, std::size_t ldc) {
+    static_assert(std::is_floating_point<T>::value,
+                  "gemm requires floating-point elements");
+    constexpr std::size_t W  = detail::algorithm_width<N, T>;
+    constexpr std::size_t NW = NR * W;
+    constexpr std::size_t MC = gemm_mc / MR ? gemm_mc / MR * MR : MR;
+    if (m == 0 || n == 0) {
+        return;
+    }
+
+    const std::size_t kc_max = k < gemm_kc ? k : gemm_kc;
+    const std::size_t mc_max = m < MC ? m : MC;
+    std::vector<T, aligned_allocator<T>>
+    pa((mc_max + MR - 1) / MR * MR * kc_max);
+    std::vector<T, aligned_allocator<T>>
+    pb((n + NW - 1) / NW * NW * kc_max);
+
+    /* k == 0 still takes one pass, which scales C by beta. */
+    std::size_t pc = 0;
+    do {
+        const std::size_t kc   = k - pc < gemm_kc ? k - pc : gemm_kc;
+        const T           beta_pass = pc == 0 ? beta : T(1);
+        gemm_pack_b<NR, W>(kc, n, b + pc * ldb, ldb, pb.data());
+
+        for (std::size_t ic = 0; ic < m; ic += MC) {
+            const std::size_t mc = m - ic < MC ? m - ic : MC;
+            gemm_pack_a<MR>(mc, kc, a + ic * lda + pc, lda, pa.data());
+
+            for (std::size_t jr = 0; jr < n; jr += NW) {
+                const T* b_panel = pb.data() + jr * kc;
+                for (std::size_t ir = 0; ir < mc; ir += MR) {
+                    gemm_microkernel<MR, NR, W>(kc, alpha, pa.data() + ir * kc,
+                                                b_panel, beta_pass,
+                                                c + (ic + ir) * ldc + jr, ldc,
+                                                mc - ir, n - jr);
+                }
+            }
+        }
+        pc += kc;
+    } while (pc < k);
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf */
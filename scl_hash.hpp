@@ -0,0 +1,346 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Hashing                                               */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* xxHash32 and xxHash64 computed for N inputs at once, one per simd lane,    */
+/* for hash joins and deduplication where std::hash or XXH64 would otherwise  */
+/* be called in a loop:                                                       */
+/*                                                                            */
+/*     simd<std::uint64_t, 8> h = scl::hash_batch(keys);                      */
+/*     scl::transform(std::span(ids), std::span(out),                         */
+/*                    [](auto k) { return scl::hash_batch(k); });             */
+/*     simd<std::uint64_t, 4> r = scl::hash_batch<4>(records);   // structs   */
+/*     simd<std::uint64_t, 8> c = scl::xxhash64_batch<8>(chunks, 4096);       */
+/*                                                                            */
+/* Every function returns exactly what the reference XXH32 / XXH64 return for */
+/* the same bytes and seed, so hashes can be stored, sent, or compared with   */
+/* other implementations. Keys passed as integer lanes are hashed as their    */
+/* little-endian bytes. Neither hash is suitable where an adversary chooses   */
+/* the keys.                                                                  */
+/*                                                                            */
+/* Lanes share no state, so the multiplies of neighbouring inputs overlap.    */
+/* Splitting one buffer's four accumulators across lanes instead would not    */
+/* pay: each round is two dependent multiplies, and a vector multiply takes   */
+/* 10 cycles where a scalar one takes 3. xxhash32 and xxhash64 therefore      */
+/* hash single buffers with the reference's four scalar accumulators.         */
+/*                                                                            */
+/* The batch functions are only as fast as the lane multiply. 32-bit lanes    */
+/* want SSE4.1 or NEON. Only AVX-512 multiplies 64-bit lanes natively; AVX2's */
+/* emulation roughly keeps pace with scalar code, while SSE2's and NEON's     */
+/* fall behind it.                                                            */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+namespace detail {
+
+inline constexpr std::uint32_t xxh32_prime1 = 0x9E3779B1u;
+inline constexpr std::uint32_t xxh32_prime2 = 0x85EBCA77u;
+inline constexpr std::uint32_t xxh32_prime3 = 0xC2B2AE3Du;
+inline constexpr std::uint32_t xxh32_prime4 = 0x27D4EB2Fu;
+inline constexpr std::uint32_t xxh32_prime5 = 0x165667B1u;
+
+inline constexpr std::uint64_t xxh64_prime1 = 0x9E3779B185EBCA87ull;
+inline constexpr std::uint64_t xxh64_prime2 = 0xC2B2AE3D27D4EB4Full;
+inline constexpr std::uint64_t xxh64_prime3 = 0x165667B19E3779F9ull;
+inline constexpr std::uint64_t xxh64_prime4 = 0x85EBCA77C2B2AE63ull;
+inline constexpr std::uint64_t xxh64_prime5 = 0x27D4EB2F165667C5ull;
+
+/* std::rotl for scalar state. Vector state finds scl::rotl by argument- */
+/* dependent lookup, so the steps below serve both.                      */
+template<typename T>
+requires std::is_unsigned<T>::value
+constexpr sf_inline T
+rotl(T x, int s) {
+    return std::rotl(x, s);
+}
+
+/* Little-endian word of 1, 4 or 8 bytes at p, zero-extended to W. */
+template<typename W>
+sf_inline W
+read_le(const unsigned char* p, std::size_t bytes) {
+    if constexpr (std::endian::native == std::endian::little) {
+        if (bytes == 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p, 8);
+            return W(w);
+        }
+        if (bytes == 4) {
+            std::uint32_t w;
+            std::memcpy(&w, p, 4);
+            return W(w);
+        }
+    }
+    W w = 0;
+    for (std::size_t i = 0; i < bytes; ++i) {
+         w |= W(W(p[i]) << (8 * i));
+    }
+    return w;
+}
+
+/* Word at byte offset of each of N inputs, lane i reading from base(i). */
+template<typename W, std::size_t N, typename Base>
+sf_inline simd<W, N>
+read_lanes(Base base, std::size_t offset, std::size_t bytes) {
+    simd<W, N> result;
+    sf_unroll(16)
+    for (std::size_t i = 0; i < N; ++i) {
+         result.data[i] = read_le<W>(base(i) + offset, bytes);
+    }
+    return result;
+}
+
+/*-------*/
+/* XXH32 */
+/*-------*/
+
+template<typename V>
+constexpr sf_inline V
+xxh32_round(const V& acc, const V& input) {
+    return rotl(acc + input * xxh32_prime2, 13) * xxh32_prime1;
+}
+
+template<typename V>
+constexpr sf_inline V
+xxh32_avalanche(const V& h) {
+    const V a = (h ^ (h >> std::uint32_t(15))) * xxh32_prime2;
+    const V b = (a ^ (a >> std::uint32_t(13))) * xxh32_prime3;
+    return b ^ (b >> std::uint32_t(16));
+}
+
+/* Consumes bytes [offset, size) after the stripes and finishes the hash. */
+/* read(offset, bytes) returns the little-endian word there as a V.       */
+template<typename V, typename Read>
+constexpr sf_always_inline V
+xxh32_finish(V h, std::size_t offset, std::size_t size, Read read) {
+    for (; offset + 4 <= size; offset += 4) {
+         h += read(offset, 4) * xxh32_prime3;
+         h  = rotl(h, 17);
+         h *= xxh32_prime4;
+    }
+    for (; offset < size; ++offset) {
+         h += read(offset, 1) * xxh32_prime5;
+         h  = rotl(h, 11);
+         h *= xxh32_prime1;
+    }
+    return xxh32_avalanche(h);
+}
+
+/* XXH32 of size bytes, each read through read(offset, bytes). */
+template<typename V, typename Read>
+constexpr sf_always_inline V
+xxh32(std::size_t size, std::uint32_t seed, Read read) {
+    if (size < 16) {
+        return xxh32_finish(V(seed + xxh32_prime5 + std::uint32_t(size)), 0, size, read);
+    }
+    std::size_t offset = 0;
+    std::array<V, 4> acc { V(seed + xxh32_prime1 + xxh32_prime2), V(seed + xxh32_prime2),
+                            V(seed), V(seed - xxh32_prime1) };
+    for (; offset + 16 <= size; offset += 16) {
+        sf_unroll(4)
+        for (std::size_t k = 0; k < 4; ++k) {
+             acc[k] += read(offset + 4 * k, 4) * xxh32_prime2;
+             acc[k]  = rotl(acc[k], 13);
+             acc[k] *= xxh32_prime1;
+        }
+    }
+    const V h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+    return xxh32_finish(h + std::uint32_t(size), offset, size, read);
+}
+
+/*-------*/
+/* XXH64 */
+/*-------*/
+
+template<typename V>
+constexpr sf_inline V
+xxh64_round(const V& acc, const V& input) {
+    return rotl(acc + input * xxh64_prime2, 31) * xxh64_prime1;
+}
+
+template<typename V>
+constexpr sf_inline V
+xxh64_merge(const V& h, const V& acc) {
+    return (h ^ xxh64_round(V(0), acc)) * xxh64_prime1 + xxh64_prime4;
+}
+
+template<typename V>
+constexpr sf_inline V
+xxh64_avalanche(const V& h) {
+    const V a = (h ^ (h >> std::uint64_t(33))) * xxh64_prime2;
+    const V b = (a ^ (a >> std::uint64_t(29))) * xxh64_prime3;
+    return b ^ (b >> std::uint64_t(32));
+}
+
+/* Combines the four stripe accumulators into the running hash. */
+template<typename V>
+constexpr sf_inline V
+xxh64_converge(const V& v1, const V& v2, const V& v3, const V& v4) {
+    const V h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    return xxh64_merge(xxh64_merge(xxh64_merge(xxh64_merge(h, v1), v2), v3), v4);
+}
+
+/* Consumes bytes [offset, size) after the stripes, as xxh32_finish. */
+template<typename V, typename Read>
+constexpr sf_always_inline V
+xxh64_finish(V h, std::size_t offset, std::size_t size, Read read) {
+    for (; offset + 8 <= size; offset += 8) {
+         h ^= xxh64_round(V(0), read(offset, 8));
+         h  = rotl(h, 27);
+         h *= xxh64_prime1;
+         h += xxh64_prime4;
+    }
+    if (offset + 4 <= size) {
+        h ^= read(offset, 4) * xxh64_prime1;
+        h  = rotl(h, 23);
+        h *= xxh64_prime2;
+        h += xxh64_prime3;
+        offset += 4;
+    }
+    for (; offset < size; ++offset) {
+         h ^= read(offset, 1) * xxh64_prime5;
+         h  = rotl(h, 11);
+         h *= xxh64_prime1;
+    }
+    return xxh64_avalanche(h);
+}
+
+/* XXH64 of size bytes, as xxh32. */
+template<typename V, typename Read>
+constexpr sf_always_inline V
+xxh64(std::size_t size, std::uint64_t seed, Read read) {
+    if (size < 32) {
+        return xxh64_finish(V(seed + xxh64_prime5 + std::uint64_t(size)), 0, size, read);
+    }
+    std::size_t offset = 0;
+    std::array<V, 4> acc { V(seed + xxh64_prime1 + xxh64_prime2), V(seed + xxh64_prime2),
+                            V(seed), V(seed - xxh64_prime1) };
+    for (; offset + 32 <= size; offset += 32) {
+        sf_unroll(4)
+        for (std::size_t k = 0; k < 4; ++k) {
+             acc[k] += read(offset + 8 * k, 8) * xxh64_prime2;
+             acc[k]  = rotl(acc[k], 31);
+             acc[k] *= xxh64_prime1;
+        }
+    }
+    const V h = xxh64_converge(acc[0], acc[1], acc[2], acc[3]);
+    return xxh64_finish(h + std::uint64_t(size), offset, size, read);
+}
+
+} /* namespace detail */
+
+/*------------*/
+/* Key Hashes */
+/*------------*/
+
+/* XXH32 of each 4-byte key. */
+template<std::size_t N>
+constexpr sf_inline simd<std::uint32_t, N>
+hash_batch(const simd<std::uint32_t, N>& keys, std::uint32_t seed = 0) {
+    using V = simd<std::uint32_t, N>;
+    const V h = V(seed + detail::xxh32_prime5 + 4) + keys * detail::xxh32_prime3;
+    return detail::xxh32_avalanche(rotl(h, 17) * detail::xxh32_prime4);
+}
+
+/* XXH64 of each 8-byte key. */
+template<std::size_t N>
+constexpr sf_inline simd<std::uint64_t, N>
+hash_batch(const simd<std::uint64_t, N>& keys, std::uint64_t seed = 0) {
+    using V = simd<std::uint64_t, N>;
+    const V h = V(seed + detail::xxh64_prime5 + 8) ^ detail::xxh64_round(V(0), keys);
+    return detail::xxh64_avalanche(rotl(h, 27) * detail::xxh64_prime1 +
+                                   detail::xxh64_prime4);
+}
+
+/* XXH64 of the bytes of each of keys[0] to keys[N - 1], one key per */
+/* lane, for fixed-size records such as composite join keys. Padding */
+/* bytes are hashed too, so keys should have none.                   */
+template<std::size_t N, typename Key>
+sf_always_inline simd<std::uint64_t, N>
+hash_batch(const Key* keys, std::uint64_t seed = 0) {
+    static_assert(std::is_trivially_copyable<Key>::value,
+                  "hash_batch requires trivially copyable keys");
+    const auto* bytes = reinterpret_cast<const unsigned char*>(keys);
+    const auto  base  = [bytes](std::size_t i) { return bytes + i * sizeof(Key); };
+    return detail::xxh64<simd<std::uint64_t, N>>(sizeof(Key), seed,
+        [base](std::size_t offset, std::size_t size) {
+            return detail::read_lanes<std::uint64_t, N>(base, offset, size);
+        });
+}
+
+/*---------------*/
+/* Buffer Hashes */
+/*---------------*/
+
+/* XXH32 of size bytes at data. */
+sf_inline std::uint32_t
+xxhash32(const void* data, std::size_t size, std::uint32_t seed = 0) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    return detail::xxh32<std::uint32_t>(size, seed,
+        [bytes](std::size_t offset, std::size_t n) {
+            return detail::read_le<std::uint32_t>(bytes + offset, n);
+        });
+}
+
+/* XXH64 of size bytes at data. */
+sf_inline std::uint64_t
+xxhash64(const void* data, std::size_t size, std::uint64_t seed = 0) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    return detail::xxh64<std::uint64_t>(size, seed,
+        [bytes](std::size_t offset, std::size_t n) {
+            return detail::read_le<std::uint64_t>(bytes + offset, n);
+        });
+}
+
+/* XXH32 of size bytes at each of buffers[0] to buffers[N - 1], for */
+/* fixed-size chunks, pages or rows.                                */
+template<std::size_t N>
+sf_inline simd<std::uint32_t, N>
+xxhash32_batch(const void* const* buffers, std::size_t size, std::uint32_t seed = 0) {
+    const auto base = [buffers](std::size_t i) {
+        return static_cast<const unsigned char*>(buffers[i]);
+    };
+    return detail::xxh32<simd<std::uint32_t, N>>(size, seed,
+        [base](std::size_t offset, std::size_t n) {
+            return detail::read_lanes<std::uint32_t, N>(base, offset, n);
+        });
+}
+
+/* XXH64 of size bytes at each of buffers[0] to buffers[N - 1]. */
+template<std::size_t N>
+sf_inline simd<std::uint64_t, N>
+xxhash64_batch(const void* const* buffers, std::size_t size, std::uint64_t seed = 0) {
+    const auto base = [buffers](std::size_t i) {
+        return static_cast<const unsigned char*>(buffers[i]);
+    };
+    return detail::xxh64<simd<std::uint64_t, N>>(size, seed,
+        [base](std::size_t offset, std::size_t n) {
+            return detail::read_lanes<std::uint64_t, N>(base, offset, n);
+        });
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
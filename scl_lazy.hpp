@@ -0,0 +1,408 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Expression Templates                                  */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Every simd operator returns a new simd. With Clang's vector extensions the */
+/* temporaries live in registers, but the std::array representation used by   */
+/* other compilers gives each operator its own loop and its own stack copy,   */
+/* which for wide types such as simd<float, 64> means a store and a reload of */
+/* every intermediate. scl::lazy defers the operators instead: once one       */
+/* operand is wrapped with lazy::ref, each operator yields a small expression */
+/* node, and converting the finished expression to simd evaluates all of it   */
+/* in a single pass over the lanes:                                           */
+/*                                                                            */
+/*     using scl::lazy::ref;                                                  */
+/*     simd<float, 64> r = (ref(a) - ref(b) * c) / d;                         */
+/*                                                                            */
+/* Precedence still decides what is deferred: in ref(a) - b * c the product   */
+/* is an ordinary eager simd, so wrap one operand of every subexpression.     */
+/* Nodes hold their simd operands by reference, so an expression must be      */
+/* evaluated before the vectors it refers to go away; the usual pattern is to */
+/* convert it in the same statement it was written in. Integer results match  */
+/* the eager operators exactly, wraparound included. Floating-point results   */
+/* may differ in the last bit, because with the whole expression in one loop  */
+/* the compiler is free to contract a * b + c into an FMA where the flag      */
+/* -ffp-contract allows it.                                                   */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf   {
+namespace scl  {
+inline namespace SCL_ISA_NAMESPACE {
+namespace lazy {
+
+template<typename E>
+class expression;
+
+namespace detail {
+
+template<typename X>
+inline constexpr bool is_node = std::is_base_of<expression<X>, X>::value;
+
+template<typename X>
+inline constexpr bool is_simd = false;
+
+template<typename T, std::size_t N>
+inline constexpr bool is_simd<simd<T, N>> = true;
+
+/* Operands of a lazy operator: at least one node, and otherwise nodes, */
+/* simd vectors or arithmetic scalars.                                 */
+template<typename X>
+inline constexpr bool is_operand = is_node<X> || is_simd<X> || std::is_arithmetic<X>::value;
+
+template<typename... X>
+concept operands = (is_node<X> || ...) && (is_operand<X> && ...);
+
+} /* namespace detail */
+
+/*-----------------------*/
+/* Expression Evaluation */
+/*-----------------------*/
+
+/* Computes every lane of e in one pass and returns the result. */
+template<typename E>
+constexpr sf_inline simd<typename E::value_type, E::width>
+evaluate(const expression<E>& e) {
+    const E& self = static_cast<const E&>(e);
+    #if defined(__clang__)
+        return self.value();
+    #else
+        std::array<typename E::value_type, E::width> result;
+        for (std::size_t i = 0; i < E::width; ++i) {
+             result[i] = self.lane(i);
+        }
+        return simd<typename E::value_type, E::width> { result };
+    #endif
+}
+
+/* Base of all expression nodes. Conversion to the matching simd type */
+/* evaluates the expression, so a node can be assigned to a simd or    */
+/* passed where one is expected.                                       */
+template<typename E>
+class expression {
+public:
+
+    template<typename T, std::size_t N>
+    constexpr
+    operator simd<T, N>() const {
+        static_assert(std::is_same<T, typename E::value_type>::value && N == E::width,
+                      "lazy expression converted to a different simd type");
+        return lazy::evaluate(*this);
+    }
+
+};
+
+/*------------------*/
+/* Expression Nodes */
+/*------------------*/
+
+/* A reference to an existing vector. */
+template<typename T, std::size_t N>
+class terminal : public expression<terminal<T, N>> {
+public:
+
+    using value_type = T;
+    static constexpr std::size_t width = N;
+
+    constexpr explicit terminal(const simd<T, N>& v) : vector(&v) {}
+
+    constexpr T
+    lane(std::size_t i) const {
+        return vector->data[i];
+    }
+
+    constexpr simd<T, N>
+    value() const {
+        return *vector;
+    }
+
+private:
+
+    const simd<T, N>* vector;
+
+};
+
+/* A scalar operand, the same in every lane. */
+template<typename T, std::size_t N>
+class scalar : public expression<scalar<T, N>> {
+public:
+
+    using value_type = T;
+    static constexpr std::size_t width = N;
+
+    constexpr explicit scalar(T x) : s(x) {}
+
+    constexpr T
+    lane(std::size_t) const {
+        return s;
+    }
+
+    constexpr simd<T, N>
+    value() const {
+        return simd<T, N>(s);
+    }
+
+private:
+
+    T s;
+
+};
+
+/* Op applied to the lanes of one, two or three child expressions. Op::apply */
+/* has an overload for scalars, used lane by lane, and one for simd, used    */
+/* when evaluating through whole vectors.                                    */
+template<typename Op, typename... Args>
+class node : public expression<node<Op, Args...>> {
+public:
+
+    using first_type = std::tuple_element_t<0, std::tuple<Args...>>;
+    using value_type = typename first_type::value_type;
+    static constexpr std::size_t width = first_type::width;
+
+    constexpr explicit node(const Args&... operands) : args(operands...) {}
+
+    constexpr value_type
+    lane(std::size_t i) const {
+        return std::apply([i](const Args&... a) {
+            return static_cast<value_type>(Op::apply(a.lane(i)...));
+        }, args);
+    }
+
+    constexpr simd<value_type, width>
+    value() const {
+        return std::apply([](const Args&... a) {
+            return simd<value_type, width>(Op::apply(a.value()...));
+        }, args);
+    }
+
+private:
+
+    std::tuple<Args...> args;
+
+};
+
+/* Wraps v, so that operators applied to the result are deferred. */
+template<typename T, std::size_t N>
+constexpr sf_inline terminal<T, N>
+ref(const simd<T, N>& v) {
+    return terminal<T, N>(v);
+}
+
+namespace detail {
+
+/* Element type and width of the first node or simd among X... */
+template<typename... X>
+struct shape;
+
+template<typename X, typename... Rest>
+struct shape<X, Rest...> : shape<Rest...> {};
+
+template<typename X, typename... Rest>
+    requires is_node<X>
+struct shape<X, Rest...> {
+    using value_type = typename X::value_type;
+    static constexpr std::size_t width = X::width;
+};
+
+template<typename T, std::size_t N, typename... Rest>
+struct shape<simd<T, N>, Rest...> {
+    using value_type = T;
+    static constexpr std::size_t width = N;
+};
+
+/* The node for one operand of an expression of type T and width N. */
+template<typename T, std::size_t N, typename X>
+constexpr sf_inline auto
+as_node(const X& x) {
+    if constexpr (is_node<X>) {
+        static_assert(std::is_same<typename X::value_type, T>::value && X::width == N,
+                      "lazy expression operands must have one simd type");
+        return x;
+    } else if constexpr (is_simd<X>) {
+        return lazy::ref<T, N>(x);
+    } else {
+        return scalar<T, N>(static_cast<T>(x));
+    }
+}
+
+template<typename Op, typename... X>
+constexpr sf_inline auto
+make_node(const X&... x) {
+    using T = typename shape<X...>::value_type;
+    constexpr std::size_t N = shape<X...>::width;
+    return node<Op, decltype(as_node<T, N>(x))...>(as_node<T, N>(x)...);
+}
+
+/*-------------------------*/
+/* Lane and Vector Kernels */
+/*-------------------------*/
+
+struct add {
+    template<typename A>
+    static constexpr auto apply(const A& a, const A& b) { return a + b; }
+};
+
+struct subtract {
+    template<typename A>
+    static constexpr auto apply(const A& a, const A& b) { return a - b; }
+};
+
+struct multiply {
+    template<typename A>
+    static constexpr auto apply(const A& a, const A& b) { return a * b; }
+};
+
+struct divide {
+    template<typename A>
+    static constexpr auto apply(const A& a, const A& b) { return a / b; }
+};
+
+struct negate {
+    template<typename A>
+    static constexpr auto apply(const A& a) { return -a; }
+};
+
+struct minimum {
+    template<typename T>
+    static constexpr T apply(T a, T b) { return b < a ? b : a; }
+
+    template<typename T, std::size_t N>
+    static constexpr simd<T, N>
+    apply(const simd<T, N>& a, const simd<T, N>& b) { return scl::min(a, b); }
+};
+
+struct maximum {
+    template<typename T>
+    static constexpr T apply(T a, T b) { return b > a ? b : a; }
+
+    template<typename T, std::size_t N>
+    static constexpr simd<T, N>
+    apply(const simd<T, N>& a, const simd<T, N>& b) { return scl::max(a, b); }
+};
+
+struct absolute {
+    template<typename T>
+    static constexpr T
+    apply(T a) {
+        if constexpr (std::is_unsigned<T>::value) {
+            return a;
+        } else if constexpr (std::is_floating_point<T>::value) {
+            return std::fabs(a);
+        } else {
+            return a < T(0) ? T(-a) : a;
+        }
+    }
+
+    template<typename T, std::size_t N>
+    static constexpr simd<T, N>
+    apply(const simd<T, N>& a) { return scl::abs(a); }
+};
+
+struct fused_multiply_add {
+    template<typename T>
+    static constexpr T
+    apply(T a, T b, T c) {
+        #if defined(SF_ISA_FMA)
+            if constexpr (std::is_floating_point<T>::value) {
+                return std::fma(a, b, c);
+            }
+        #endif
+        return static_cast<T>(a * b + c);
+    }
+
+    template<typename T, std::size_t N>
+    static constexpr simd<T, N>
+    apply(const simd<T, N>& a, const simd<T, N>& b, const simd<T, N>& c) {
+        return scl::fma(a, b, c);
+    }
+};
+
+} /* namespace detail */
+
+/*-----------*/
+/* Operators */
+/*-----------*/
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+operator+(const A& a, const B& b) {
+    return detail::make_node<detail::add>(a, b);
+}
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+operator-(const A& a, const B& b) {
+    return detail::make_node<detail::subtract>(a, b);
+}
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+operator*(const A& a, const B& b) {
+    return detail::make_node<detail::multiply>(a, b);
+}
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+operator/(const A& a, const B& b) {
+    return detail::make_node<detail::divide>(a, b);
+}
+
+template<typename A> requires detail::operands<A>
+constexpr sf_inline auto
+operator-(const A& a) {
+    return detail::make_node<detail::negate>(a);
+}
+
+/*-----------*/
+/* Functions */
+/*-----------*/
+
+/* Deferred counterparts of scl::min, max, abs and fma. They are found  */
+/* by argument-dependent lookup whenever an argument is a lazy node.   */
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+min(const A& a, const B& b) {
+    return detail::make_node<detail::minimum>(a, b);
+}
+
+template<typename A, typename B> requires detail::operands<A, B>
+constexpr sf_inline auto
+max(const A& a, const B& b) {
+    return detail::make_node<detail::maximum>(a, b);
+}
+
+template<typename A> requires detail::operands<A>
+constexpr sf_inline auto
+abs(const A& a) {
+    return detail::make_node<detail::absolute>(a);
+}
+
+template<typename A, typename B, typename C> requires detail::operands<A, B, C>
+constexpr sf_inline auto
+fma(const A& a, const B& b, const C& c) {
+    return detail::make_node<detail::fused_multiply_add>(a, b, c);
+}
+
+} /* namespace lazy */
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl  */
+} /* namespace sf   */
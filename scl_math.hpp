@@ -0,0 +1,857 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Elementary Functions                                  */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Element-wise exp, log, sin, cos, tan, atan, atan2, pow, sqrt and rsqrt for */
+/* simd<float, N> and simd<double, N>. Every function is written in terms of  */
+/* the simd operators and select(), so it vectorizes on the same paths as     */
+/* the rest of the library instead of calling into libm lane by lane.         */
+/*                                                                            */
+/* The polynomials are taken from Cephes and evaluated after Cody-Waite range */
+/* reduction, or Payne-Hanek reduction for very large trigonometric           */
+/* arguments. Maximum errors, measured against a higher-precision reference   */
+/* over the stated ranges, are listed with each function. Results that would  */
+/* be subnormal are computed correctly.                                       */
+/*                                                                            */
+/* -ffast-math is not required. With it the listed bounds still hold to       */
+/* within an ulp or two, since the steps that depend on exact rounding go     */
+/* through scl::detail::value_barrier, but subnormal results flush to zero,   */
+/* the sign of zero is not kept, NaN and infinity are not handled and exp may */
+/* overflow slightly early.                                                   */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf   {
+namespace scl  {
+inline namespace SCL_ISA_NAMESPACE {
+namespace math {
+
+namespace detail {
+
+/*-----------------------------*/
+/* Floating-Point Format Traits */
+/*-----------------------------*/
+
+template<typename T>
+struct float_traits;
+
+template<>
+struct float_traits<float> {
+    using bits_type = std::int32_t;
+
+    static constexpr bits_type mantissa_bits = 23;
+    static constexpr bits_type exponent_bias = 127;
+
+    /* 1.5 * 2^23: adding and subtracting it rounds to the nearest integer. */
+    static constexpr float round_magic   = 12582912.0f;
+    static constexpr float min_normal    = 1.17549435e-38f;
+    static constexpr float subnormal_fix = 8388608.0f;
+
+    /* exp overflows above log(FLT_MAX) and underflows below log(2^-150). */
+    static constexpr float exp_hi        =  88.7228391f;
+    static constexpr float exp_lo        = -103.972077f;
+};
+
+template<>
+struct float_traits<double> {
+    using bits_type = std::int64_t;
+
+    static constexpr bits_type mantissa_bits = 52;
+    static constexpr bits_type exponent_bias = 1023;
+
+    /* 1.5 * 2^52: adding and subtracting it rounds to the nearest integer. */
+    static constexpr double round_magic   = 6755399441055744.0;
+    static constexpr double min_normal    = 2.2250738585072014e-308;
+    static constexpr double subnormal_fix = 4503599627370496.0;
+
+    /* exp overflows above log(DBL_MAX) and underflows below log(2^-1075). */
+    static constexpr double exp_hi        =  709.782712893384;
+    static constexpr double exp_lo        = -745.133219101941;
+};
+
+template<typename T, std::size_t N>
+using bits_simd = simd<typename float_traits<T>::bits_type, N>;
+
+/*---------------------*/
+/* Bit-Level Utilities */
+/*---------------------*/
+
+/* Reinterpret float lanes as their IEEE-754 bit patterns. */
+template<typename T, std::size_t N>
+constexpr sf_inline bits_simd<T, N>
+as_bits(const simd<T, N>& x) {
+    return scl::bit_cast<typename float_traits<T>::bits_type>(x);
+}
+
+/* Reinterpret IEEE-754 bit patterns as float lanes. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+from_bits(const bits_simd<T, N>& x) {
+    return scl::bit_cast<T>(x);
+}
+
+/* Round to the nearest integer, ties to even. This goes through the     */
+/* rounding instructions where there are any, and otherwise through a    */
+/* magic-number addition that -ffast-math cannot fold away.              */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+round_nearest(const simd<T, N>& x) {
+    return scl::detail::round_to<scl::detail::rounding::nearest>(x);
+}
+
+/* Round down to an integer. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+round_down(const simd<T, N>& x) {
+    return scl::floor(x);
+}
+
+/* Convert integral-valued float lanes to integers. */
+template<typename T, std::size_t N>
+constexpr sf_inline bits_simd<T, N>
+to_integer(const simd<T, N>& x) {
+    constexpr T magic = float_traits<T>::round_magic;
+    const bits_simd<T, N> bias = as_bits(simd<T, N>(magic));
+    return as_bits(x + magic) - bias;
+}
+
+/* Convert small integers to float lanes. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+to_float(const bits_simd<T, N>& x) {
+    constexpr T magic = float_traits<T>::round_magic;
+    const bits_simd<T, N> bias = as_bits(simd<T, N>(magic));
+    return from_bits<T, N>(x + bias) - magic;
+}
+
+/* 2^k for integral-valued k inside the normal exponent range. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+exp2_integer(const simd<T, N>& k) {
+    using traits    = float_traits<T>;
+    using bits_type = typename traits::bits_type;
+    return from_bits<T, N>((to_integer(k) + traits::exponent_bias)
+                           << bits_type(traits::mantissa_bits));
+}
+
+/* Evaluate a polynomial by Horner's rule, highest-order coefficient first. */
+template<typename T, std::size_t N, typename... C>
+constexpr sf_inline simd<T, N>
+horner(const simd<T, N>& x, T c0, C... cs) {
+    simd<T, N> result(c0);
+    ((result = scl::fma(result, x, simd<T, N>(T(cs)))), ...);
+    return result;
+}
+
+/* a - b, rounded, with the rounding error in e: a - b = s + e exactly */
+/* (Knuth's TwoSum), whatever the relative magnitudes of a and b. The  */
+/* barriers keep -ffast-math from regrouping the terms of e, which     */
+/* would cancel it to zero.                                            */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+two_diff(const simd<T, N>& a, const simd<T, N>& b, simd<T, N>& e) {
+    const simd<T, N> s  = scl::detail::value_barrier(a - b);
+    const simd<T, N> bb = scl::detail::value_barrier(a - s);
+    const simd<T, N> ea = scl::detail::value_barrier(a - scl::detail::value_barrier(s + bb));
+    const simd<T, N> eb = scl::detail::value_barrier(bb - b);
+    e = ea + eb;
+    return s;
+}
+
+/* a * b, rounded, with the rounding error in e: a * b = p + e exactly,  */
+/* barring overflow. Without a hardware FMA the operands are split into */
+/* halves (Dekker's TwoProduct), which needs |a| and |b| well below the */
+/* overflow threshold.                                                  */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+two_prod(const simd<T, N>& a, const simd<T, N>& b, simd<T, N>& e) {
+    const simd<T, N> p = scl::detail::value_barrier(a * b);
+    #if defined(SF_ISA_FMA)
+        e = scl::fma(a, b, -p);
+    #else
+        constexpr T split = T(std::uint64_t(1) << (std::numeric_limits<T>::digits + 1) / 2) + T(1);
+        const simd<T, N> ta = scl::detail::value_barrier(a * split);
+        const simd<T, N> tb = scl::detail::value_barrier(b * split);
+        const simd<T, N> ah = ta - scl::detail::value_barrier(ta - a);
+        const simd<T, N> bh = tb - scl::detail::value_barrier(tb - b);
+        const simd<T, N> al = a - ah;
+        const simd<T, N> bl = b - bh;
+        e = scl::detail::value_barrier(scl::detail::value_barrier(ah * bh - p) + ah * bl);
+        e = scl::detail::value_barrier(e + al * bh) + al * bl;
+    #endif
+    return p;
+}
+
+/* 2/pi in 32-bit words, most significant first, with enough bits for */
+/* the largest double: 2/pi = sum of two_over_pi[i] * 2^(-32 * (i+1)). */
+inline constexpr std::uint32_t two_over_pi[] = {
+    0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0, 0xDB629599, 0x3C439041,
+    0xFE5163AB, 0xDEBBC561, 0xB7246E3A, 0x424DD2E0, 0x06492EEA, 0x09D1921C,
+    0xFE1DEB1C, 0xB129A73E, 0xE88235F5, 0x2EBB4484, 0xE99C7026, 0xB45F7E41,
+    0x3991D639, 0x835339F4, 0x9C845F8B, 0xBDF9283B, 0x1FF897FF, 0xDE05980F,
+    0xEF2F118B, 0x5A0A6D1F, 0x6D367ECF, 0x27CB09B7, 0x4F463F66, 0x9E5FEA2D,
+    0x7527BAC7, 0xEBE5F17B, 0x3D0739F7, 0x8A5292EA, 0x6BFB5FB1, 0x1F8D5D08,
+    0x56033046, 0xFC7B6BAB, 0xF0CFBC20
+};
+
+/* High 64 bits of the 128-bit product a * b. */
+constexpr sf_inline std::uint64_t
+mul_high(std::uint64_t a, std::uint64_t b) {
+    const std::uint64_t a_lo = a & 0xFFFFFFFFu;
+    const std::uint64_t a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xFFFFFFFFu;
+    const std::uint64_t b_hi = b >> 32;
+    const std::uint64_t lh   = a_lo * b_hi;
+    const std::uint64_t hl   = a_hi * b_lo;
+    const std::uint64_t mid  = ((a_lo * b_lo) >> 32) + (lh & 0xFFFFFFFFu) +
+                               (hl & 0xFFFFFFFFu);
+    return a_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/* Payne-Hanek reduction of one finite x with |x| >= 2^20: the same r   */
+/* and quadrant as reduce_quadrant, for arguments where q * pi/2 can no */
+/* longer be formed exactly in floating point. The mantissa of x is     */
+/* multiplied by the 224 bits of 2/pi that matter at its exponent, in   */
+/* integer arithmetic, which leaves the fraction exact to about 2^-138  */
+/* and unaffected by -ffast-math; r is rounded once at the end.         */
+constexpr sf_inline double
+reduce_quadrant_large(double x, double& r) {
+    constexpr int           words = 7;
+    constexpr int           limbs = words + 2;
+    /* pi/2 * 2^62 */
+    constexpr std::uint64_t pio2  = 0x6487ED5110B4611Au;
+
+    const std::uint64_t bits     = std::bit_cast<std::uint64_t>(x);
+    const std::uint64_t mantissa = (bits & ((std::uint64_t(1) << 52) - 1)) |
+                                   (std::uint64_t(1) << 52);
+    const int           exponent = int((bits >> 52) & 0x7FF) - 1075;
+
+    /* Words before first only add multiples of 4 to x * 2/pi. */
+    const int first = exponent > 2 ? (exponent - 2) / 32 : 0;
+    std::uint32_t p[limbs] = {};
+    for (int k = 0; k < words; ++k) {
+        const std::uint64_t w     = two_over_pi[first + words - 1 - k];
+        std::uint64_t       carry = 0;
+        for (int l = 0; l < 2; ++l) {
+            const std::uint64_t t = std::uint64_t(p[k + l]) +
+                                    w * ((mantissa >> (32 * l)) & 0xFFFFFFFFu) +
+                                    carry;
+            p[k + l] = std::uint32_t(t);
+            carry    = t >> 32;
+        }
+        p[k + 2] = std::uint32_t(carry);
+    }
+
+    /* x * 2/pi = p * 2^-point. Round to the nearest quadrant and keep */
+    /* the magnitude of the remaining fraction in the low point bits.  */
+    const int  point = 32 * (first + words) - exponent;
+    const auto bit   = [&](int i) { return (p[i >> 5] >> (i & 31)) & 1u; };
+    const bool up    = bit(point - 1) != 0;
+    int        q     = int(bit(point) | (bit(point + 1) << 1)) + (up ? 1 : 0);
+    if (up) {
+        std::uint64_t carry = 1;
+        for (int k = 0; k < limbs; ++k) {
+            const std::uint64_t t = std::uint64_t(~p[k]) + carry;
+            p[k]  = std::uint32_t(t);
+            carry = t >> 32;
+        }
+    }
+    for (int k = 0; k < limbs; ++k) {
+        if (32 * k >= point) {
+            p[k] = 0;
+        } else if (32 * k + 32 > point) {
+            p[k] &= (std::uint32_t(1) << (point - 32 * k)) - 1;
+        }
+    }
+
+    /* The leading 64 bits of the fraction, times pi/2. */
+    int top = point - 1;
+    while (top >= 0 && bit(top) == 0) {
+        --top;
+    }
+    std::uint64_t fraction = 0;
+    for (int i = top; i > top - 64; --i) {
+        fraction = (fraction << 1) | (i >= 0 ? bit(i) : 0u);
+    }
+    const int     scale = top - 61 - point;
+    const double  pow2  = std::bit_cast<double>(std::uint64_t(1023 + scale) << 52);
+    const double  value = top < 0 ? 0.0 : double(mul_high(fraction, pio2)) * pow2;
+
+    r = up ? -value : value;
+    if (x < 0) {
+        r = -r;
+        q = -q;
+    }
+    return double(q & 3);
+}
+
+/* Reduce x to r in [-pi/4, pi/4] with x = r + q * pi/2, and return the */
+/* quadrant q mod 4 as a float in {0, 1, 2, 3}.                         */
+/*                                                                      */
+/* pi/2 is split as P1 + P2 + P3 + P4, where P1 to P3 have 33 bits so   */
+/* that q * Pi is exact for |x| < 2^20. Near a multiple of pi/2 the     */
+/* terms cancel down to r, so the rounding errors of the subtractions   */
+/* are kept with two_diff and added back with q * P4. a is computed     */
+/* behind a barrier so that -ffast-math cannot merge q * P1 and q * P2. */
+/* Lanes with |x| >= 2^20 are redone with reduce_quadrant_large, one   */
+/* at a time. float lanes are reduced in double, which leaves r exact   */
+/* to far below a float ulp.                                            */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+reduce_quadrant(const simd<T, N>& x, simd<T, N>& r) {
+    if constexpr (std::is_same<T, float>::value) {
+        simd<double, N>       rd;
+        const simd<double, N> q = reduce_quadrant(convert<double>(x), rd);
+        r = convert<float>(rd);
+        return convert<float>(q);
+    } else {
+        const simd<T, N> q = round_nearest(x * T(0.636619772367581343076));
+        const simd<T, N> a = scl::detail::value_barrier(
+                             x - q * T(1.57079632673412561417e+00));
+        simd<T, N>       e1;
+        simd<T, N>       e2;
+        const simd<T, N> b = two_diff(a, q * T(6.07710050630396597660e-11), e1);
+        const simd<T, N> c = two_diff(b, q * T(2.02226624871116645580e-21), e2);
+        r = c + ((e1 + e2) - q * T(8.47842766036889956997e-32));
+        simd<T, N> quadrant = q - round_down(q * T(0.25)) * T(4);
+
+        const simd<T, N> ax    = select<T, N>(x < T(0), -x, x);
+        const auto       large = (ax >= T(1048576.0)) &
+                                 (ax <= std::numeric_limits<T>::max());
+        if (horizontal_or<T, N>(large)) {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (large[i]) {
+                    double ri = 0.0;
+                    quadrant.set(i, reduce_quadrant_large(x[i], ri));
+                    r.set(i, ri);
+                }
+            }
+        }
+        return quadrant;
+    }
+}
+
+/* sin(r) for r in [-pi/4, pi/4]. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+sin_kernel(const simd<T, N>& r) {
+    const simd<T, N> z = r * r;
+    if constexpr (std::is_same<T, float>::value) {
+        return horner(z, -1.9515295891e-4f,
+                          8.3321608736e-3f,
+                         -1.6666654611e-1f) * z * r + r;
+    } else {
+        return r + r * z * horner(z,  1.58962301576546568060e-10,
+                                     -2.50507477628578072866e-8,
+                                      2.75573136213857245213e-6,
+                                     -1.98412698295895385996e-4,
+                                      8.33333333332211858878e-3,
+                                     -1.66666666666666307295e-1);
+    }
+}
+
+/* cos(r) for r in [-pi/4, pi/4]. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+cos_kernel(const simd<T, N>& r) {
+    const simd<T, N> z = r * r;
+    if constexpr (std::is_same<T, float>::value) {
+        return horner(z,  2.443315711809948e-5f,
+                         -1.388731625493765e-3f,
+                          4.166664568298827e-2f) * z * z - z * 0.5f + 1.0f;
+    } else {
+        return T(1) - z * T(0.5) + z * z * horner(z, -1.13585365213876817300e-11,
+                                                      2.08757008419747316778e-9,
+                                                     -2.75573141792967388112e-7,
+                                                      2.48015872888517045348e-5,
+                                                     -1.38888888888730564116e-3,
+                                                      4.16666666666665929218e-2);
+    }
+}
+
+/*------------------------*/
+/* Logarithm Computations */
+/*------------------------*/
+
+/* Splits positive x = m * 2^k with m in [sqrt(0.5), sqrt(2)), subnormal */
+/* x included, so that log(x) = k * log(2) + log(m) with |m - 1| small.  */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+log_reduce(const simd<T, N>& x, simd<T, N>& k) {
+    using V         = simd<T, N>;
+    using traits    = float_traits<T>;
+    using bits_type = typename traits::bits_type;
+    using I         = bits_simd<T, N>;
+
+    /* Bring subnormals into the normal range before splitting the bits. */
+    const auto subnormal = x < traits::min_normal;
+    const V    scaled    = select<T, N>(subnormal, x * traits::subnormal_fix, x);
+    const V    offset    = select<T, N>(subnormal,
+                                        V(T(-traits::mantissa_bits)), V(T(0)));
+
+    /* Split scaled = m * 2^e with m in [0.5, 1). */
+    const I   bits = as_bits(scaled);
+    const I   e    = (bits >> bits_type(traits::mantissa_bits))
+                   - bits_type(traits::exponent_bias - 1);
+    const V   m    = from_bits<T, N>(bits - (e << bits_type(traits::mantissa_bits)));
+              k    = to_float<T, N>(e) + offset;
+
+    /* Shift m into [sqrt(0.5), sqrt(2)) around one. */
+    const auto low = m < T(0.707106781186547524);
+    k = select<T, N>(low, k - T(1), k);
+    return select<T, N>(low, m + m, m);
+}
+
+/* log(x) for double lanes as an unevaluated sum hi + lo, returning hi,  */
+/* with a relative error of about 2^-66, for pow: y * log(x) has to be   */
+/* good to much more than a double ulp once |y * log(x)| is large. Zero, */
+/* infinity and NaN give the hi of math::log and an unspecified lo.      */
+/*                                                                       */
+/* log(m) is 2 * atanh(s) = 2s + s^3 * (2/3 + 2s^2/5 + 2s^4/7 + ...) for */
+/* s = (m - 1) / (m + 1), |s| < 0.172. s and the s^3 * 2/3 term are     */
+/* kept in double-double, the rest of the series only in double.        */
+template<std::size_t N>
+constexpr sf_inline simd<double, N>
+log_extended(const simd<double, N>& x, simd<double, N>& lo) {
+    using V = simd<double, N>;
+
+    V       k;
+    const V m = log_reduce(x, k);
+
+    /* s = sh + sl = f / (uh + ul), where f = m - 1 is exact. */
+    const V f  = m - 1.0;
+    V       ul;
+    const V uh = two_diff(m, V(-1.0), ul);
+    const V sh = f / uh;
+    V       pe;
+    const V p  = two_prod(sh, uh, pe);
+    const V sl = ((scl::detail::value_barrier(f - p) - pe) - sh * ul) / uh;
+
+    /* s^3 = s3h + s3l. */
+    V       we;
+    const V w   = two_prod(sh, sh, we);
+    V       s3e;
+    const V s3h = two_prod(sh, w, s3e);
+    const V s3l = s3e + sh * we + 3.0 * w * sl;
+
+    /* c = ch + cl = 2/3 + 2s^2/5 + ... + 2s^20/23; 2/3 is split as well. */
+    const V r  = w * horner(w, 2.0 / 23.0, 2.0 / 21.0, 2.0 / 19.0, 2.0 / 17.0,
+                               2.0 / 15.0, 2.0 / 13.0, 2.0 / 11.0, 2.0 /  9.0,
+                               2.0 /  7.0, 2.0 /  5.0);
+    V       ce;
+    const V ch = two_diff(V(2.0 / 3.0), -r, ce);
+    const V cl = ce + 3.7007434154171883e-17;
+
+    /* log(m) = 2s + s^3 * c = ah + al. */
+    V       te;
+    const V th = two_prod(s3h, ch, te);
+    const V tl = te + s3h * cl + s3l * ch;
+    V       ae;
+    const V ah = two_diff(sh + sh, -th, ae);
+    const V al = ae + (sl + sl + tl);
+
+    /* Add k * log(2), whose high part has 32 trailing zero bits. */
+    V       ke;
+    const V kh = two_diff(k * 6.93147180369123816490e-01, -ah, ke);
+    const V kl = ke + al + k * 1.90821492927058770002e-10;
+
+    V result = two_diff(kh, -kl, lo);
+    result = select<double, N>(x == std::numeric_limits<double>::infinity(), x, result);
+    result = select<double, N>(x == 0.0,
+                               V(-std::numeric_limits<double>::infinity()), result);
+    return   select<double, N>(x != x, x, result);
+}
+
+/*-------------------------*/
+/* Exponential Computation */
+/*-------------------------*/
+
+/* e^x, or e^(x + tail) for |tail| below an ulp of x when Tail is set. */
+/* The tail is applied as a factor 1 + tail before the scaling by 2^n, */
+/* so that it still counts where the result is subnormal.              */
+template<bool Tail, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+exp_kernel(const simd<T, N>& x, const simd<T, N>& tail) {
+    using V      = simd<T, N>;
+    using traits = float_traits<T>;
+
+    /* Clamp so the reduction stays finite; out-of-range lanes are fixed */
+    /* up at the end.                                                    */
+    V v = select<T, N>(x > traits::exp_hi, V(T(traits::exp_hi)), x);
+      v = select<T, N>(v < traits::exp_lo, V(T(traits::exp_lo)), v);
+
+    const V n = round_nearest(v * T(1.44269504088896340736));
+    V p;
+    if constexpr (std::is_same<T, float>::value) {
+        const V r = scl::detail::value_barrier(v - n * 0.693359375f) - n * -2.12194440e-4f;
+        p = horner(r, 1.9875691500e-4f,
+                      1.3981999507e-3f,
+                      8.3334519073e-3f,
+                      4.1665795894e-2f,
+                      1.6666665459e-1f,
+                      5.0000001201e-1f) * r * r + r + 1.0f;
+    } else {
+        const V r  = scl::detail::value_barrier(v - n * 6.93145751953125e-1) -
+                     n * 1.42860682030941723212e-6;
+        const V rr = r * r;
+        const V px = r * horner(rr, 1.26177193074810590878e-4,
+                                    3.02994407707441961300e-2,
+                                    9.99999999999999999910e-1);
+        const V qx = horner(rr, 3.00198505138664455042e-6,
+                                2.52448340349684104192e-3,
+                                2.27265548208155028766e-1,
+                                2.00000000000000000009e0);
+        p = (px / (qx - px)) * T(2) + T(1);
+    }
+    if constexpr (Tail) {
+        p = p + scl::detail::value_barrier(p * tail);
+    } else {
+        sf_unused_parameter(tail);
+    }
+
+    /* Scale by 2^n in two steps so that n near either end of the range,  */
+    /* including results that land in the subnormals, stays exact.       */
+    const V n1 = round_down(n * T(0.5));
+    V result = p * exp2_integer(n1) * exp2_integer(n - n1);
+
+    result = select<T, N>(x > traits::exp_hi,
+                          V(std::numeric_limits<T>::infinity()), result);
+    result = select<T, N>(x < traits::exp_lo, V(T(0)), result);
+    return   select<T, N>(x != x, x, result);
+}
+
+} /* namespace detail */
+
+/*------------------------------------*/
+/* Exponential and Logarithm Functions */
+/*------------------------------------*/
+
+/* e^x. Max error 1 ulp (float) / 2 ulp (double) over the full range;     */
+/* overflows to +inf and underflows through the subnormals to zero.       */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+exp(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::exp requires floating-point lanes");
+    return detail::exp_kernel<false>(x, simd<T, N>(T(0)));
+}
+
+/* Natural logarithm. Max error 1 ulp (float) / 1 ulp (double). Returns   */
+/* -inf for zero, NaN for negative inputs and +inf for +inf.              */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+log(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::log requires floating-point lanes");
+    using V = simd<T, N>;
+
+    V       k;
+    const V f = detail::log_reduce(x, k) - T(1);
+    const V z = f * f;
+
+    V y;
+    if constexpr (std::is_same<T, float>::value) {
+        y = detail::horner(f,  7.0376836292e-2f,
+                              -1.1514610310e-1f,
+                               1.1676998740e-1f,
+                              -1.2420140846e-1f,
+                               1.4249322787e-1f,
+                              -1.6668057665e-1f,
+                               2.0000714765e-1f,
+                              -2.4999993993e-1f,
+                               3.3333331174e-1f) * f * z;
+    } else {
+        const V p = detail::horner(f,  1.01875663804580931796e-4,
+                                       4.97494994976747001425e-1,
+                                       4.70579119878881725854e0,
+                                       1.44989225341610930846e1,
+                                       1.79368678507819816313e1,
+                                       7.70838733755885391666e0);
+        const V q = detail::horner(f,  1.0,
+                                       1.12873587189167450590e1,
+                                       4.52279145837532221105e1,
+                                       8.29875266912776603211e1,
+                                       7.11544750618563894466e1,
+                                       2.31251620126765340583e1);
+        y = f * (z * p / q);
+    }
+    y = y + k * T(-2.12194440054690582768e-4) - z * T(0.5);
+    V result = f + y + k * T(0.693359375);
+
+    result = select<T, N>(x == std::numeric_limits<T>::infinity(), x, result);
+    result = select<T, N>(x == T(0),
+                          V(-std::numeric_limits<T>::infinity()), result);
+    result = select<T, N>(x < T(0),
+                          V(std::numeric_limits<T>::quiet_NaN()), result);
+    return   select<T, N>(x != x, x, result);
+}
+
+/* x^y computed as exp(y * log(|x|)). Max error 1 ulp (float) / 3 ulp   */
+/* (double) over the full range: y * log(x) is formed in double for     */
+/* float and in double-double for double, so the error does not grow    */
+/* with its magnitude.                                                  */
+/* Zero, unit and negative bases follow std::pow: a negative base gives a */
+/* real result only for integral y.                                       */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+pow(const simd<T, N>& x, const simd<T, N>& y) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::pow requires floating-point lanes");
+    using V = simd<T, N>;
+
+    const V    ax       = select<T, N>(x < T(0), -x, x);
+    V          result;
+    if constexpr (std::is_same<T, float>::value) {
+        /* y scales the error of log(x) up by |y * log(x)|; in double it  */
+        /* stays far below a float ulp, so the result is nearly correctly */
+        /* rounded.                                                       */
+        const simd<double, N> yd = convert<double>(y);
+        result = convert<float>(math::exp(yd * math::log(convert<double>(ax))));
+    } else {
+        /* t = th + tl = y * log(x) in double-double, and exp(th + tl) is */
+        /* exp(th) * (1 + tl). The correction is skipped where y * log(x) */
+        /* is too large for the split to be exact, or exp saturates.      */
+        V          ll;
+        const V    lh       = detail::log_extended(ax, ll);
+        V          te;
+        const V    th       = detail::two_prod(y, lh, te);
+        const auto in_range = (th < T(1024)) & (th > T(-1024));
+        const V    tl       = select<T, N>(in_range, te + y * ll, V(T(0)));
+        V          tc;
+        const V    t        = detail::two_diff(th, -tl, tc);
+        result = detail::exp_kernel<true>(t, select<T, N>(in_range, tc, V(T(0))));
+    }
+
+    const V    yi       = detail::round_down(y);
+    const auto integral = yi == y;
+    const auto odd      = integral &
+                          (detail::round_down(yi * T(0.5)) * T(2) != yi);
+
+    const V    negated  = select<T, N>(odd, -result, result);
+    result = select<T, N>(x < T(0),
+                          select<T, N>(integral, negated,
+                                       V(std::numeric_limits<T>::quiet_NaN())),
+                          result);
+    result = select<T, N>((y == T(0)) | (x == T(1)), V(T(1)), result);
+    return   result;
+}
+
+/*------------------------*/
+/* Trigonometric Functions */
+/*------------------------*/
+
+/* Sine. Max error 2 ulp over the whole range, including x close to     */
+/* multiples of pi. Lanes with |x| >= 2^20 take a much slower exact     */
+/* reduction, one lane at a time. sin(-0) is -0.                        */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+sin(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::sin requires floating-point lanes");
+    simd<T, N> r;
+    const simd<T, N> q = detail::reduce_quadrant(x, r);
+    const simd<T, N> s = detail::sin_kernel(r);
+    const simd<T, N> c = detail::cos_kernel(r);
+    const simd<T, N> v = select<T, N>((q == T(1)) | (q == T(3)), c, s);
+    /* The polynomial term rounds sin(-0) to +0. */
+    return select<T, N>(x == T(0), x, select<T, N>(q >= T(2), -v, v));
+}
+
+/* Cosine. Same error and range as sin. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+cos(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::cos requires floating-point lanes");
+    simd<T, N> r;
+    const simd<T, N> q = detail::reduce_quadrant(x, r);
+    const simd<T, N> s = detail::sin_kernel(r);
+    const simd<T, N> c = detail::cos_kernel(r);
+    const simd<T, N> v = select<T, N>((q == T(1)) | (q == T(3)), s, c);
+    return select<T, N>((q == T(1)) | (q == T(2)), -v, v);
+}
+
+/* Tangent. Max error 4 ulp over the same range as sin. tan(-0) is -0. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+tan(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::tan requires floating-point lanes");
+    simd<T, N> r;
+    const simd<T, N> q = detail::reduce_quadrant(x, r);
+    const simd<T, N> s = detail::sin_kernel(r);
+    const simd<T, N> c = detail::cos_kernel(r);
+    return select<T, N>(x == T(0), x,
+                        select<T, N>((q == T(1)) | (q == T(3)), -c / s, s / c));
+}
+
+/* Arc tangent in [-pi/2, pi/2]. Max error 3 ulp (float) / 1 ulp (double). */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+atan(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::atan requires floating-point lanes");
+    using V = simd<T, N>;
+
+    constexpr T pi_2 = T(1.57079632679489661923);
+    constexpr T pi_4 = T(0.78539816339744830962);
+
+    /* Fold |x| into [0, tan(pi/8)] with atan(x) = y0 + atan(t). */
+    const V    a   = select<T, N>(x < T(0), -x, x);
+    const auto big = a > T(2.41421356237309504880);
+    const auto mid = ~big & (a > (std::is_same<T, float>::value ?
+                                  T(0.4142135623730950) : T(0.66)));
+    const V    t   = select<T, N>(big, T(-1) / a,
+                     select<T, N>(mid, (a - T(1)) / (a + T(1)), a));
+    const V    y0  = select<T, N>(big, V(pi_2),
+                     select<T, N>(mid, V(pi_4), V(T(0))));
+    const V    z   = t * t;
+
+    V result;
+    if constexpr (std::is_same<T, float>::value) {
+        result = detail::horner(z,  8.05374449538e-2f,
+                                   -1.38776856032e-1f,
+                                    1.99777106478e-1f,
+                                   -3.33329491539e-1f) * z * t + t + y0;
+    } else {
+        /* Low bits of pi/2 lost in y0, added back for the folded ranges. */
+        constexpr T more_bits = 6.123233995736765886130e-17;
+        const V extra = select<T, N>(big, V(more_bits),
+                        select<T, N>(mid, V(more_bits * 0.5), V(T(0))));
+        const V p = detail::horner(z, -8.750608600031904122785e-1,
+                                      -1.615753718733365076637e1,
+                                      -7.500855792314704667340e1,
+                                      -1.228866684490136173410e2,
+                                      -6.485021904942025371773e1);
+        const V q = detail::horner(z,  1.0,
+                                       2.485846490142306297962e1,
+                                       1.650270098316988542046e2,
+                                       4.328810604912902668951e2,
+                                       4.853903996359136964868e2,
+                                       1.945506571482613964425e2);
+        result = y0 + ((t * (z * p / q) + t) + extra);
+    }
+    return select<T, N>(x < T(0), -result, result);
+}
+
+/* Arc tangent of y/x in [-pi, pi], using the signs of both arguments to  */
+/* choose the quadrant. Max error 3 ulp (float) / 2 ulp (double). Signed  */
+/* zeros are not told apart, so atan2(-0, -1) returns +pi, and two        */
+/* infinite arguments give NaN.                                           */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+atan2(const simd<T, N>& y, const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::atan2 requires floating-point lanes");
+    using V = simd<T, N>;
+
+    constexpr T pi   = T(3.14159265358979323846);
+    constexpr T pi_2 = T(1.57079632679489661923);
+
+    V result = math::atan(y / x);
+    result = select<T, N>(x < T(0),
+                          result + select<T, N>(y < T(0), V(-pi), V(pi)),
+                          result);
+    return select<T, N>(x == T(0),
+                        select<T, N>(y > T(0), V(pi_2),
+                        select<T, N>(y < T(0), V(-pi_2), V(T(0)))),
+                        result);
+}
+
+/*-----------------------*/
+/* Square Root Functions */
+/*-----------------------*/
+
+/* Correctly rounded square root. Uses the native vector instruction on   */
+/* Clang and x86; elsewhere the lane loop is vectorized when math errno   */
+/* is disabled (-fno-math-errno). Constant evaluation goes through        */
+/* std::sqrt, so it needs a compiler that folds it, like GCC, until the   */
+/* C++26 constexpr <cmath>.                                               */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+sqrt(const simd<T, N>& x) {
+    static_assert(std::is_floating_point<T>::value,
+                  "math::sqrt requires floating-point lanes");
+    if (std::is_constant_evaluated()) {
+        simd<T, N> result;
+        for (std::size_t i = 0; i < N; ++i) {
+             result.data[i] = std::sqrt(x.data[i]);
+        }
+        return result;
+    }
+    #if defined(__clang__) && sf_has_builtin(__builtin_elementwise_sqrt)
+        return simd<T, N> { __builtin_elementwise_sqrt(x.data) };
+    #else
+        simd<T, N> result;
+        const T* src = reinterpret_cast<const T*>(&x.data);
+        T*       dst = reinterpret_cast<T*>(&result.data);
+        #if defined(SF_ISA_AVX512F)
+        if constexpr (sizeof(T) * N % 64 == 0) {
+            for (std::size_t i = 0; i < N; i += 64 / sizeof(T)) {
+                /* Full-mask forms; the unmasked intrinsics trip -Wuninitialized on GCC. */
+                if constexpr (std::is_same<T, float>::value) {
+                    _mm512_storeu_ps(dst + i, _mm512_maskz_sqrt_ps(__mmask16(0xFFFF), 
+                                                                   _mm512_loadu_ps(src + i)));
+                } else {
+                    _mm512_storeu_pd(dst + i, _mm512_maskz_sqrt_pd(__mmask8(0xFF), 
+                                                                   _mm512_loadu_pd(src + i)));
+                }
+            }
+            return result;
+        } else
+        #endif
+        #if defined(SF_ISA_AVX)
+        if constexpr (sizeof(T) * N % 32 == 0) {
+            for (std::size_t i = 0; i < N; i += 32 / sizeof(T)) {
+                if constexpr (std::is_same<T, float>::value) {
+                    _mm256_storeu_ps(dst + i, _mm256_sqrt_ps(_mm256_loadu_ps(src + i)));
+                } else {
+                    _mm256_storeu_pd(dst + i, _mm256_sqrt_pd(_mm256_loadu_pd(src + i)));
+                }
+            }
+            return result;
+        } else
+        #endif
+        #if defined(SF_ISA_SSE2)
+        if constexpr (sizeof(T) * N % 16 == 0) {
+            for (std::size_t i = 0; i < N; i += 16 / sizeof(T)) {
+                if constexpr (std::is_same<T, float>::value) {
+                    _mm_storeu_ps(dst + i, _mm_sqrt_ps(_mm_loadu_ps(src + i)));
+                } else {
+                    _mm_storeu_pd(dst + i, _mm_sqrt_pd(_mm_loadu_pd(src + i)));
+                }
+            }
+            return result;
+        } else
+        #endif
+        {
+            for (std::size_t i = 0; i < N; ++i) {
+                 dst[i] = std::sqrt(src[i]);
+            }
+            return result;
+        }
+    #endif
+}
+
+/* Reciprocal square root, 1 / sqrt(x). Max error 2 ulp. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+rsqrt(const simd<T, N>& x) {
+    return T(1) / math::sqrt(x);
+}
+
+} /* namespace math */
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl  */
+} /* namespace sf   */
@@ -0,0 +1,506 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Small Matrices and Quaternions                        */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* mat4f and mat3f hold their rows as simd<float, 4>, and quatf holds x, y,   */
+/* z and w in the four lanes of one simd<float, 4>. Vectors are columns, so   */
+/* m * v transforms v and a * b applies b first. mat3f rows and the vectors   */
+/* it is applied to use lanes x, y and z; its w lanes are kept at zero.       */
+/* Products, transposes and inverses are built from shuffle and permute, and  */
+/* stay in registers from start to finish.                                    */
+/*                                                                            */
+/* One matrix applied to many vertices is faster in structure-of-arrays form, */
+/* with x, y and z of N vertices in the lanes of three simd<float, N>. The    */
+/* batch types are the std::array that load_interleaved returns, so packed    */
+/* xyz data goes through a transform with no other conversion:                */
+/*                                                                            */
+/*     auto p = load_interleaved<3, float, 8>(positions + 3 * i);             */
+/*     store_interleaved(positions + 3 * i, transform_points(model, p));      */
+/*                                                                            */
+/* Each matrix entry is broadcast once per call, and every output lane costs  */
+/* three or four fma, the same as the scalar code, but for N vertices at a    */
+/* time.                                                                      */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+/* Structure-of-arrays batches of N three- and four-component vectors. */
+template<std::size_t N>
+using vec3_batch = std::array<simd<float, N>, 3>;
+
+template<std::size_t N>
+using vec4_batch = std::array<simd<float, N>, 4>;
+
+namespace detail {
+
+using vec4f = simd<float, 4>;
+
+/* Lane I of v in every lane. */
+template<std::size_t I>
+constexpr sf_inline vec4f
+splat(const vec4f& v) {
+    return permute<I, I, I, I>(v);
+}
+
+/* Cross product of the xyz lanes; w of the result is zero. */
+constexpr sf_inline vec4f
+cross(const vec4f& a, const vec4f& b) {
+    return permute<1, 2, 0, 3>(a) * permute<2, 0, 1, 3>(b) -
+           permute<2, 0, 1, 3>(a) * permute<1, 2, 0, 3>(b);
+}
+
+/* Transpose of the 4x4 matrix with rows r0 to r3, in place. */
+constexpr sf_inline void
+transpose4(vec4f& r0, vec4f& r1, vec4f& r2, vec4f& r3) {
+    const vec4f t0 = shuffle<0, 4, 1, 5>(r0, r1);
+    const vec4f t1 = shuffle<2, 6, 3, 7>(r0, r1);
+    const vec4f t2 = shuffle<0, 4, 1, 5>(r2, r3);
+    const vec4f t3 = shuffle<2, 6, 3, 7>(r2, r3);
+    r0 = shuffle<0, 1, 4, 5>(t0, t2);
+    r1 = shuffle<2, 3, 6, 7>(t0, t2);
+    r2 = shuffle<0, 1, 4, 5>(t1, t3);
+    r3 = shuffle<2, 3, 6, 7>(t1, t3);
+}
+
+/* 2x2 matrices packed row-major into one vector, [a b; c d] = (a, b, c, d), */
+/* used by the block inverse of mat4f.                                       */
+
+/* a * b */
+constexpr sf_inline vec4f
+mat2_mul(const vec4f& a, const vec4f& b) {
+    return fma(a, permute<0, 3, 0, 3>(b),
+               permute<1, 0, 3, 2>(a) * permute<2, 1, 2, 1>(b));
+}
+
+/* adjugate(a) * b */
+constexpr sf_inline vec4f
+mat2_adj_mul(const vec4f& a, const vec4f& b) {
+    return permute<3, 3, 0, 0>(a) * b -
+           permute<1, 1, 2, 2>(a) * permute<2, 3, 0, 1>(b);
+}
+
+/* a * adjugate(b) */
+constexpr sf_inline vec4f
+mat2_mul_adj(const vec4f& a, const vec4f& b) {
+    return a * permute<3, 0, 3, 0>(b) -
+           permute<1, 0, 3, 2>(a) * permute<2, 1, 2, 1>(b);
+}
+
+} /* namespace detail */
+
+/*-----------------------------*/
+/* Matrix and Quaternion Types */
+/*-----------------------------*/
+
+class mat4f {
+public:
+
+    using row_type = simd<float, 4>;
+
+    std::array<row_type, 4> rows;
+
+    mat4f() = default;
+
+    constexpr mat4f(const row_type& r0, const row_type& r1,
+                    const row_type& r2, const row_type& r3)
+    : rows { r0, r1, r2, r3 } {}
+
+    static constexpr mat4f
+    identity() {
+        return mat4f(row_type { 1.0f, 0.0f, 0.0f, 0.0f },
+                     row_type { 0.0f, 1.0f, 0.0f, 0.0f },
+                     row_type { 0.0f, 0.0f, 1.0f, 0.0f },
+                     row_type { 0.0f, 0.0f, 0.0f, 1.0f });
+    }
+
+    constexpr row_type&
+    operator[](std::size_t i) {
+        return rows[i];
+    }
+
+    constexpr const row_type&
+    operator[](std::size_t i) const {
+        return rows[i];
+    }
+
+};
+
+class mat3f {
+public:
+
+    using row_type = simd<float, 4>;
+
+    std::array<row_type, 3> rows;
+
+    mat3f() = default;
+
+    /* The w lane of each row is cleared. */
+    constexpr mat3f(const row_type& r0, const row_type& r1, const row_type& r2)
+    : rows { cutoff(r0, 3), cutoff(r1, 3), cutoff(r2, 3) } {}
+
+    static constexpr mat3f
+    identity() {
+        return mat3f(row_type { 1.0f, 0.0f, 0.0f, 0.0f },
+                     row_type { 0.0f, 1.0f, 0.0f, 0.0f },
+                     row_type { 0.0f, 0.0f, 1.0f, 0.0f });
+    }
+
+    constexpr row_type&
+    operator[](std::size_t i) {
+        return rows[i];
+    }
+
+    constexpr const row_type&
+    operator[](std::size_t i) const {
+        return rows[i];
+    }
+
+};
+
+/* A rotation, as x, y, z and w in lanes 0 to 3 of one vector. Only unit */
+/* quaternions represent rotations; rotate and to_mat3 assume one.       */
+class quatf {
+public:
+
+    using vector_type = simd<float, 4>;
+
+    vector_type data;
+
+    quatf() = default;
+
+    explicit constexpr quatf(const vector_type& xyzw) : data(xyzw) {}
+
+    constexpr quatf(float x, float y, float z, float w)
+    : data { x, y, z, w } {}
+
+    static constexpr quatf
+    identity() {
+        return quatf(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    /* Rotation by angle radians about a unit axis, given in lanes xyz. */
+    static quatf
+    from_axis_angle(const vector_type& axis, float angle) {
+        const float s = std::sin(0.5f * angle);
+        const float c = std::cos(0.5f * angle);
+        return quatf(cutoff(axis * s, 3) + vector_type { 0.0f, 0.0f, 0.0f, c });
+    }
+
+};
+
+/*----------------------*/
+/* 4x4 Matrix Functions */
+/*----------------------*/
+
+constexpr sf_inline mat4f
+transpose(const mat4f& m) {
+    mat4f t = m;
+    detail::transpose4(t.rows[0], t.rows[1], t.rows[2], t.rows[3]);
+    return t;
+}
+
+/* Row i of a * b is the sum over k of a[i][k] * b[k]. */
+constexpr sf_inline mat4f
+operator*(const mat4f& a, const mat4f& b) {
+    mat4f result;
+    for (std::size_t i = 0; i < 4; ++i) {
+        const simd<float, 4>& r = a.rows[i];
+        result.rows[i] = fma(detail::splat<3>(r), b.rows[3],
+                         fma(detail::splat<2>(r), b.rows[2],
+                         fma(detail::splat<1>(r), b.rows[1],
+                             detail::splat<0>(r) * b.rows[0])));
+    }
+    return result;
+}
+
+/* m * v, as the columns of m weighted by the lanes of v. */
+constexpr sf_inline simd<float, 4>
+operator*(const mat4f& m, const simd<float, 4>& v) {
+    const mat4f t = transpose(m);
+    return fma(t.rows[3], detail::splat<3>(v),
+           fma(t.rows[2], detail::splat<2>(v),
+           fma(t.rows[1], detail::splat<1>(v),
+               t.rows[0] * detail::splat<0>(v))));
+}
+
+/* General inverse by 2x2 blocks, [A B; C D], with the inverse Schur      */
+/* complements written through adjugates so that only one division by the */
+/* determinant remains. A singular m gives infinite or NaN entries.       */
+constexpr sf_inline mat4f
+inverse(const mat4f& m) {
+    using detail::vec4f;
+    const vec4f& r0 = m.rows[0];
+    const vec4f& r1 = m.rows[1];
+    const vec4f& r2 = m.rows[2];
+    const vec4f& r3 = m.rows[3];
+
+    const vec4f a = shuffle<0, 1, 4, 5>(r0, r1);
+    const vec4f b = shuffle<2, 3, 6, 7>(r0, r1);
+    const vec4f c = shuffle<0, 1, 4, 5>(r2, r3);
+    const vec4f d = shuffle<2, 3, 6, 7>(r2, r3);
+
+    /* Determinants of a, b, c and d, in that order. */
+    const vec4f det_sub = shuffle<0, 2, 4, 6>(r0, r2) * shuffle<1, 3, 5, 7>(r1, r3) -
+                          shuffle<1, 3, 5, 7>(r0, r2) * shuffle<0, 2, 4, 6>(r1, r3);
+    const vec4f det_a = detail::splat<0>(det_sub);
+    const vec4f det_b = detail::splat<1>(det_sub);
+    const vec4f det_c = detail::splat<2>(det_sub);
+    const vec4f det_d = detail::splat<3>(det_sub);
+
+    const vec4f d_c = detail::mat2_adj_mul(d, c);
+    const vec4f a_b = detail::mat2_adj_mul(a, b);
+
+    vec4f x = det_d * a - detail::mat2_mul(b, d_c);
+    vec4f w = det_a * d - detail::mat2_mul(c, a_b);
+    vec4f y = det_b * c - detail::mat2_mul_adj(d, a_b);
+    vec4f z = det_c * b - detail::mat2_mul_adj(a, d_c);
+
+    const float trace = (a_b * permute<0, 2, 1, 3>(d_c)).horizontal_sum();
+    const float det   = det_sub[0] * det_sub[3] + det_sub[1] * det_sub[2] - trace;
+
+    /* The blocks come out as adjugates, transposed and with alternating */
+    /* signs, which the scale and the final shuffles undo.               */
+    const vec4f scale = vec4f { 1.0f, -1.0f, -1.0f, 1.0f } / det;
+    x *= scale;
+    y *= scale;
+    z *= scale;
+    w *= scale;
+
+    return mat4f(shuffle<3, 1, 7, 5>(x, y),
+                 shuffle<2, 0, 6, 4>(x, y),
+                 shuffle<3, 1, 7, 5>(z, w),
+                 shuffle<2, 0, 6, 4>(z, w));
+}
+
+/*----------------------*/
+/* 3x3 Matrix Functions */
+/*----------------------*/
+
+constexpr sf_inline mat3f
+transpose(const mat3f& m) {
+    detail::vec4f r0 = m.rows[0];
+    detail::vec4f r1 = m.rows[1];
+    detail::vec4f r2 = m.rows[2];
+    detail::vec4f r3 = detail::vec4f(0.0f);
+    detail::transpose4(r0, r1, r2, r3);
+    return mat3f(r0, r1, r2);
+}
+
+constexpr sf_inline mat3f
+operator*(const mat3f& a, const mat3f& b) {
+    mat3f result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const simd<float, 4>& r = a.rows[i];
+        result.rows[i] = fma(detail::splat<2>(r), b.rows[2],
+                         fma(detail::splat<1>(r), b.rows[1],
+                             detail::splat<0>(r) * b.rows[0]));
+    }
+    return result;
+}
+
+/* m * v for the xyz lanes of v; w of the result is zero. */
+constexpr sf_inline simd<float, 4>
+operator*(const mat3f& m, const simd<float, 4>& v) {
+    const mat3f t = transpose(m);
+    return fma(t.rows[2], detail::splat<2>(v),
+           fma(t.rows[1], detail::splat<1>(v),
+               t.rows[0] * detail::splat<0>(v)));
+}
+
+/* The columns of the adjugate are cross products of pairs of rows, and */
+/* the determinant is the triple product. A singular m gives infinite   */
+/* or NaN entries.                                                      */
+constexpr sf_inline mat3f
+inverse(const mat3f& m) {
+    const detail::vec4f c0 = detail::cross(m.rows[1], m.rows[2]);
+    const detail::vec4f c1 = detail::cross(m.rows[2], m.rows[0]);
+    const detail::vec4f c2 = detail::cross(m.rows[0], m.rows[1]);
+    const float det = detail::vec4f::dot_product(m.rows[0], c0);
+
+    const mat3f adjugate = transpose(mat3f(c0, c1, c2));
+    const detail::vec4f scale(1.0f / det);
+    return mat3f(adjugate.rows[0] * scale,
+                 adjugate.rows[1] * scale,
+                 adjugate.rows[2] * scale);
+}
+
+/*----------------------*/
+/* Quaternion Functions */
+/*----------------------*/
+
+/* Hamilton product: the rotation b followed by a. */
+constexpr sf_inline quatf
+operator*(const quatf& a, const quatf& b) {
+    using detail::vec4f;
+    const vec4f& p = a.data;
+    const vec4f& q = b.data;
+    const vec4f  x = permute<3, 2, 1, 0>(q) * vec4f {  1.0f, -1.0f,  1.0f, -1.0f };
+    const vec4f  y = permute<2, 3, 0, 1>(q) * vec4f {  1.0f,  1.0f, -1.0f, -1.0f };
+    const vec4f  z = permute<1, 0, 3, 2>(q) * vec4f { -1.0f,  1.0f,  1.0f, -1.0f };
+    return quatf(fma(detail::splat<2>(p), z,
+                 fma(detail::splat<1>(p), y,
+                 fma(detail::splat<0>(p), x,
+                     detail::splat<3>(p) * q))));
+}
+
+constexpr sf_inline quatf
+conjugate(const quatf& q) {
+    return quatf(q.data * detail::vec4f { -1.0f, -1.0f, -1.0f, 1.0f });
+}
+
+/* The conjugate divided by the squared norm; for a unit quaternion the */
+/* conjugate alone is cheaper and exact.                                */
+constexpr sf_inline quatf
+inverse(const quatf& q) {
+    const float norm = detail::vec4f::dot_product(q.data, q.data);
+    return quatf(conjugate(q).data / norm);
+}
+
+inline quatf
+normalize(const quatf& q) {
+    const float norm = detail::vec4f::dot_product(q.data, q.data);
+    return quatf(q.data * (1.0f / std::sqrt(norm)));
+}
+
+/* Rotates the xyz lanes of v by a unit quaternion, as             */
+/* v + w * t + cross(u, t) with u = q.xyz and t = 2 * cross(u, v). */
+constexpr sf_inline simd<float, 4>
+rotate(const quatf& q, const simd<float, 4>& v) {
+    const detail::vec4f u = cutoff(q.data, 3);
+    const detail::vec4f t = detail::cross(u, v) * 2.0f;
+    return cutoff(v, 3) + fma(detail::splat<3>(q.data), t, detail::cross(u, t));
+}
+
+/* The rotation matrix of a unit quaternion. */
+constexpr sf_inline mat3f
+to_mat3(const quatf& q) {
+    const float x = q.data[0];
+    const float y = q.data[1];
+    const float z = q.data[2];
+    const float w = q.data[3];
+    return mat3f(
+        simd<float, 4> { 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z),
+                         2.0f * (x * z + w * y), 0.0f },
+        simd<float, 4> { 2.0f * (x * y + w * z), 1.0f - 2.0f * (x * x + z * z),
+                         2.0f * (y * z - w * x), 0.0f },
+        simd<float, 4> { 2.0f * (x * z - w * y), 2.0f * (y * z + w * x),
+                         1.0f - 2.0f * (x * x + y * y), 0.0f });
+}
+
+/* to_mat3 with a zero translation. */
+constexpr sf_inline mat4f
+to_mat4(const quatf& q) {
+    const mat3f r = to_mat3(q);
+    return mat4f(r.rows[0], r.rows[1], r.rows[2],
+                 simd<float, 4> { 0.0f, 0.0f, 0.0f, 1.0f });
+}
+
+/*-----------------------------------*/
+/* Batched Structure-of-Arrays Forms */
+/*-----------------------------------*/
+
+/* m * (x, y, z, 1) for N points, without the division by w, which is */
+/* one for affine m.                                                  */
+template<std::size_t N>
+constexpr sf_inline vec3_batch<N>
+transform_points(const mat4f& m, const vec3_batch<N>& p) {
+    using V = simd<float, N>;
+    vec3_batch<N> result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const simd<float, 4>& r = m.rows[i];
+        result[i] = fma(V(r.data[2]), p[2],
+                    fma(V(r.data[1]), p[1],
+                    fma(V(r.data[0]), p[0], V(r.data[3]))));
+    }
+    return result;
+}
+
+/* m * (x, y, z, 0) for N directions: the translation is ignored. */
+template<std::size_t N>
+constexpr sf_inline vec3_batch<N>
+transform_vectors(const mat4f& m, const vec3_batch<N>& v) {
+    using V = simd<float, N>;
+    vec3_batch<N> result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const simd<float, 4>& r = m.rows[i];
+        result[i] = fma(V(r.data[2]), v[2],
+                    fma(V(r.data[1]), v[1],
+                        V(r.data[0]) * v[0]));
+    }
+    return result;
+}
+
+/* m * v for N homogeneous vectors, such as positions into clip space. */
+template<std::size_t N>
+constexpr sf_inline vec4_batch<N>
+operator*(const mat4f& m, const vec4_batch<N>& v) {
+    using V = simd<float, N>;
+    vec4_batch<N> result;
+    for (std::size_t i = 0; i < 4; ++i) {
+        const simd<float, 4>& r = m.rows[i];
+        result[i] = fma(V(r.data[3]), v[3],
+                    fma(V(r.data[2]), v[2],
+                    fma(V(r.data[1]), v[1],
+                        V(r.data[0]) * v[0])));
+    }
+    return result;
+}
+
+template<std::size_t N>
+constexpr sf_inline vec3_batch<N>
+operator*(const mat3f& m, const vec3_batch<N>& v) {
+    using V = simd<float, N>;
+    vec3_batch<N> result;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const simd<float, 4>& r = m.rows[i];
+        result[i] = fma(V(r.data[2]), v[2],
+                    fma(V(r.data[1]), v[1],
+                        V(r.data[0]) * v[0]));
+    }
+    return result;
+}
+
+/* Rotates N vectors by one unit quaternion, by the same formula as the */
+/* single-vector rotate.                                                */
+template<std::size_t N>
+constexpr sf_inline vec3_batch<N>
+rotate(const quatf& q, const vec3_batch<N>& v) {
+    using V = simd<float, N>;
+    const V qx(q.data.data[0]);
+    const V qy(q.data.data[1]);
+    const V qz(q.data.data[2]);
+    const V qw(q.data.data[3]);
+
+    const V tx = (qy * v[2] - qz * v[1]) * 2.0f;
+    const V ty = (qz * v[0] - qx * v[2]) * 2.0f;
+    const V tz = (qx * v[1] - qy * v[0]) * 2.0f;
+
+    return vec3_batch<N> {
+        v[0] + fma(qw, tx, qy * tz - qz * ty),
+        v[1] + fma(qw, ty, qz * tx - qx * tz),
+        v[2] + fma(qw, tz, qx * ty - qy * tx)
+    };
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
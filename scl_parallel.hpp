@@ -0,0 +1,460 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Multithreaded Algorithms                              */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* scl::par runs the span algorithms of scl_algorithm.hpp across a pool of    */
+/* threads. One core cannot saturate the memory bus of a socket, so kernels   */
+/* that stream through arrays much larger than the last-level cache only      */
+/* reach full bandwidth when several cores issue loads at once:               */
+/*                                                                            */
+/*     float total = scl::par::transform_reduce(std::span(a), std::span(b),   */
+/*                                              0.0f);                        */
+/*                                                                            */
+/* The input is cut into fixed-size chunks of SCL_PARALLEL_CHUNK_BYTES, which */
+/* start on page boundaries of the input when its base is page-aligned, and  */
+/* each chunk runs the ordinary single-threaded simd algorithm. Every thread  */
+/* owns one contiguous run of chunks and steals single chunks from the other  */
+/* runs once its own is done, so uneven cores or a preempted thread do not    */
+/* leave the rest idle. Because thread t always starts on the same run for a  */
+/* given size, pages that a par:: pass first touched are revisited by the     */
+/* thread, and hence the NUMA node, that faulted them in.                     */
+/*                                                                            */
+/* Reductions fold each chunk into its own partial and combine the partials  */
+/* in chunk order. Since chunk boundaries depend only on the input size, the */
+/* result is the same for any thread count and any schedule, although it can */
+/* still differ from the single-threaded algorithm in the last bits.         */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/* SCL Includes */
+#include "scl_algorithm.hpp"
+
+/* Bytes of the leading input handled by one task. Large enough that the */
+/* scheduling cost is noise next to streaming the chunk from memory, and */
+/* small enough to leave dozens of chunks per thread for load balancing. */
+#ifndef SCL_PARALLEL_CHUNK_BYTES
+   #define SCL_PARALLEL_CHUNK_BYTES (256 * 1024)
+#endif
+
+namespace sf  {
+namespace scl {
+namespace par {
+
+/*-------------*/
+/* Thread Pool */
+/*-------------*/
+
+/* A fixed set of worker threads that execute parallel_for loops. The      */
+/* calling thread takes part in each loop as one of the size() threads,    */
+/* and loops issued from inside a loop run inline on the thread that      */
+/* issued them. Loops from different external threads are serialized.    */
+class thread_pool {
+public:
+
+    explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency())
+    : thread_count(threads > 0 ? threads : 1),
+      ranges(new range[thread_count]) {
+        workers.reserve(thread_count - 1);
+        for (std::size_t slot = 1; slot < thread_count; ++slot) {
+             workers.emplace_back([this, slot] { work(slot); });
+        }
+    }
+
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+             worker.join();
+        }
+    }
+
+    /* Threads taking part in a loop, the caller included. */
+    std::size_t
+    size() const {
+        return thread_count;
+    }
+
+    /* Calls f(i) once for every i in [0, count), spread across the pool,  */
+    /* and returns when all calls have finished. If any call throws, the  */
+    /* remaining calls are skipped and the first exception is rethrown.   */
+    template<typename F>
+    void
+    parallel_for(std::size_t count, F&& f) {
+        if (count == 0) {
+            return;
+        }
+        if (count == 1 || thread_count == 1 || inside_loop()) {
+            for (std::size_t i = 0; i < count; ++i) {
+                 f(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> serial(submit);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t slot = 0; slot < thread_count; ++slot) {
+                 ranges[slot].next.store(count * slot / thread_count,
+                                         std::memory_order_relaxed);
+                 ranges[slot].end = count * (slot + 1) / thread_count;
+            }
+            job_context = const_cast<void*>(static_cast<const void*>(&f));
+            job_invoke  = [](void* context, std::size_t i) {
+                (*static_cast<std::remove_reference_t<F>*>(context))(i);
+            };
+            failure   = nullptr;
+            cancelled.store(false, std::memory_order_relaxed);
+            pending   = thread_count - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        run(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending == 0; });
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+private:
+
+    /* The chunk indices one thread starts on; next runs past end once */
+    /* the range is exhausted, by owner and thieves alike.             */
+    struct alignas(64) range {
+        std::atomic<std::size_t> next {0};
+        std::size_t              end = 0;
+    };
+
+    static bool&
+    inside_loop() {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void
+    work(std::size_t slot) {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+            run(slot);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) {
+                    done.notify_one();
+                }
+            }
+        }
+    }
+
+    /* Drains the thread's own range, then the others in turn. */
+    void
+    run(std::size_t slot) {
+        inside_loop() = true;
+        for (std::size_t k = 0; k < thread_count; ++k) {
+            range& r = ranges[(slot + k) % thread_count];
+            for (std::size_t i; (i = r.next.fetch_add(1, std::memory_order_relaxed)) < r.end;) {
+                if (cancelled.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                try {
+                    job_invoke(job_context, i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!failure) {
+                        failure = std::current_exception();
+                    }
+                    cancelled.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+        inside_loop() = false;
+    }
+
+    std::size_t                thread_count;
+    std::unique_ptr<range[]>   ranges;
+    std::vector<std::thread>   workers;
+
+    std::mutex                 submit;
+    std::mutex                 mutex;
+    std::condition_variable    wake;
+    std::condition_variable    done;
+    std::size_t                generation = 0;
+    std::size_t                pending    = 0;
+    bool                       stopping   = false;
+
+    void*                      job_context = nullptr;
+    void                     (*job_invoke)(void*, std::size_t) = nullptr;
+    std::exception_ptr         failure;
+    std::atomic<bool>          cancelled {false};
+
+};
+
+/* The pool used by the overloads below that do not take one. It has one */
+/* thread per hardware thread and is created on first use.                */
+inline thread_pool&
+default_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+/* The pool above is shared by every instruction set variant; the loops */
+/* below are compiled per variant like the rest of scl.                 */
+inline namespace SCL_ISA_NAMESPACE {
+
+namespace detail {
+
+/* Elements of T per chunk, a whole number of pages for any T. */
+template<typename T>
+inline constexpr std::size_t chunk_elements =
+SCL_PARALLEL_CHUNK_BYTES / sizeof(T) > 0 ? SCL_PARALLEL_CHUNK_BYTES / sizeof(T) : 1;
+
+sf_inline std::size_t
+chunk_count(std::size_t n, std::size_t chunk) {
+    return (n + chunk - 1) / chunk;
+}
+
+/* Reduces [0, n) as chunks of the given size. partial(begin, end)      */
+/* reduces one chunk without an initial value; partials are combined in */
+/* chunk order, after init, with combine(a, b).                         */
+template<typename R, typename Partial, typename Combine>
+R
+reduce_chunks(thread_pool& pool, std::size_t n, std::size_t chunk, R init,
+              Partial partial, Combine combine) {
+    const std::size_t chunks = chunk_count(n, chunk);
+    std::vector<R>    partials(chunks);
+    pool.parallel_for(chunks, [&](std::size_t c) {
+        partials[c] = partial(c * chunk, std::min(n, c * chunk + chunk));
+    });
+    R result = init;
+    for (const R& p : partials) {
+         result = combine(result, p);
+    }
+    return result;
+}
+
+} /* namespace detail */
+
+/*-----------*/
+/* Transform */
+/*-----------*/
+
+/* scl::transform, one chunk per task. */
+template<std::size_t N = 0, typename T, std::size_t E1,
+                            typename U, std::size_t E2, typename F>
+void
+transform(thread_pool& pool, std::span<T, E1> in, std::span<U, E2> out, F f) {
+    constexpr std::size_t chunk = detail::chunk_elements<std::remove_cv_t<T>>;
+    const std::size_t n = in.size();
+    pool.parallel_for(detail::chunk_count(n, chunk), [&](std::size_t c) {
+        const std::size_t begin = c * chunk;
+        const std::size_t count = std::min(chunk, n - begin);
+        scl::transform<N>(in.subspan(begin, count), out.subspan(begin, count), f);
+    });
+}
+
+template<std::size_t N = 0, typename T, std::size_t E1,
+                            typename U, std::size_t E2, typename F>
+void
+transform(std::span<T, E1> in, std::span<U, E2> out, F f) {
+    par::transform<N>(default_pool(), in, out, f);
+}
+
+/* Binary scl::transform, one chunk per task. */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2,
+                            typename U,  std::size_t E3, typename F>
+void
+transform(thread_pool& pool, std::span<T1, E1> a, std::span<T2, E2> b,
+          std::span<U, E3> out, F f) {
+    constexpr std::size_t chunk = detail::chunk_elements<std::remove_cv_t<T1>>;
+    const std::size_t n = a.size();
+    pool.parallel_for(detail::chunk_count(n, chunk), [&](std::size_t c) {
+        const std::size_t begin = c * chunk;
+        const std::size_t count = std::min(chunk, n - begin);
+        scl::transform<N>(a.subspan(begin, count), b.subspan(begin, count),
+                          out.subspan(begin, count), f);
+    });
+}
+
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2,
+                            typename U,  std::size_t E3, typename F>
+void
+transform(std::span<T1, E1> a, std::span<T2, E2> b, std::span<U, E3> out, F f) {
+    par::transform<N>(default_pool(), a, b, out, f);
+}
+
+/*------------*/
+/* Reductions */
+/*------------*/
+
+/* Chunk reductions have no identity element to start from, so each one */
+/* is seeded with its own first element and reduces the rest.           */
+
+/* scl::reduce, one chunk per task. */
+template<std::size_t N = 0, typename T, std::size_t E, typename Op>
+std::remove_cv_t<T>
+reduce(thread_pool& pool, std::span<T, E> in, std::remove_cv_t<T> init, Op op) {
+    using VT = std::remove_cv_t<T>;
+    return detail::reduce_chunks<VT>(pool, in.size(), detail::chunk_elements<VT>, init,
+        [&](std::size_t begin, std::size_t end) {
+            return scl::reduce<N>(in.subspan(begin + 1, end - begin - 1), in[begin], op);
+        },
+        [&](VT a, VT b) { return scl::detail::apply_scalar(op, a, b); });
+}
+
+template<std::size_t N = 0, typename T, std::size_t E, typename Op>
+std::remove_cv_t<T>
+reduce(std::span<T, E> in, std::remove_cv_t<T> init, Op op) {
+    return par::reduce<N>(default_pool(), in, init, op);
+}
+
+/* Sum of all elements. */
+template<std::size_t N = 0, typename T, std::size_t E>
+std::remove_cv_t<T>
+reduce(std::span<T, E> in) {
+    return par::reduce<N>(default_pool(), in, std::remove_cv_t<T>{}, std::plus<>{});
+}
+
+/* scl::transform_reduce, one chunk per task. */
+template<std::size_t N = 0, typename T, std::size_t E, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(thread_pool& pool, std::span<T, E> in, R init,
+                 ReduceOp reduce_op, TransformOp transform_op) {
+    using VT = std::remove_cv_t<T>;
+    constexpr std::size_t W = scl::detail::algorithm_width<N, VT>;
+    return detail::reduce_chunks<R>(pool, in.size(), detail::chunk_elements<VT>, init,
+        [&](std::size_t begin, std::size_t end) {
+            const R seed = simd<R, W>(transform_op(
+                scl::detail::load_partial_block<VT, W>(in.data() + begin, 1)))[0];
+            return scl::transform_reduce<N>(in.subspan(begin + 1, end - begin - 1),
+                                            seed, reduce_op, transform_op);
+        },
+        [&](R a, R b) { return scl::detail::apply_scalar(reduce_op, a, b); });
+}
+
+template<std::size_t N = 0, typename T, std::size_t E, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(std::span<T, E> in, R init,
+                 ReduceOp reduce_op, TransformOp transform_op) {
+    return par::transform_reduce<N>(default_pool(), in, init, reduce_op, transform_op);
+}
+
+/* Binary scl::transform_reduce, one chunk per task. */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(thread_pool& pool, std::span<T1, E1> a, std::span<T2, E2> b,
+                 R init, ReduceOp reduce_op, TransformOp transform_op) {
+    using V1 = std::remove_cv_t<T1>;
+    using V2 = std::remove_cv_t<T2>;
+    constexpr std::size_t W = scl::detail::algorithm_width<N, V1>;
+    return detail::reduce_chunks<R>(pool, a.size(), detail::chunk_elements<V1>, init,
+        [&](std::size_t begin, std::size_t end) {
+            const R seed = simd<R, W>(transform_op(
+                scl::detail::load_partial_block<V1, W>(a.data() + begin, 1),
+                scl::detail::load_partial_block<V2, W>(b.data() + begin, 1)))[0];
+            return scl::transform_reduce<N>(a.subspan(begin + 1, end - begin - 1),
+                                            b.subspan(begin + 1, end - begin - 1),
+                                            seed, reduce_op, transform_op);
+        },
+        [&](R x, R y) { return scl::detail::apply_scalar(reduce_op, x, y); });
+}
+
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R,
+         typename ReduceOp, typename TransformOp>
+R
+transform_reduce(std::span<T1, E1> a, std::span<T2, E2> b, R init,
+                 ReduceOp reduce_op, TransformOp transform_op) {
+    return par::transform_reduce<N>(default_pool(), a, b, init, reduce_op, transform_op);
+}
+
+/* Inner product of a and b plus init, one chunk per task. */
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R>
+R
+transform_reduce(thread_pool& pool, std::span<T1, E1> a, std::span<T2, E2> b,
+                 R init) {
+    return detail::reduce_chunks<R>(pool, a.size(), detail::chunk_elements<R>, init,
+        [&](std::size_t begin, std::size_t end) {
+            return scl::transform_reduce<N>(a.subspan(begin + 1, end - begin - 1),
+                                            b.subspan(begin + 1, end - begin - 1),
+                                            R(a[begin] * b[begin]));
+        },
+        [](R x, R y) { return x + y; });
+}
+
+template<std::size_t N = 0, typename T1, std::size_t E1,
+                            typename T2, std::size_t E2, typename R>
+R
+transform_reduce(std::span<T1, E1> a, std::span<T2, E2> b, R init) {
+    return par::transform_reduce<N>(default_pool(), a, b, init);
+}
+
+/*----------*/
+/* Counting */
+/*----------*/
+
+/* scl::count_if, one chunk per task. */
+template<std::size_t N = 0, typename T, std::size_t E, typename Pred>
+std::size_t
+count_if(thread_pool& pool, std::span<T, E> in, Pred pred) {
+    using VT = std::remove_cv_t<T>;
+    return detail::reduce_chunks<std::size_t>(pool, in.size(),
+        detail::chunk_elements<VT>, 0,
+        [&](std::size_t begin, std::size_t end) {
+            return scl::count_if<N>(in.subspan(begin, end - begin), pred);
+        },
+        [](std::size_t x, std::size_t y) { return x + y; });
+}
+
+template<std::size_t N = 0, typename T, std::size_t E, typename Pred>
+std::size_t
+count_if(std::span<T, E> in, Pred pred) {
+    return par::count_if<N>(default_pool(), in, pred);
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace par */
+} /* namespace scl */
+} /* namespace sf  */
@@ -0,0 +1,184 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Random Number Generation                              */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* random_engine<N> runs N independent xoshiro256+ generators side by side,   */
+/* one per lane of four simd<std::uint64_t, N> state vectors. A step is six   */
+/* xors, two shifts, a rotate and an add on whole vectors, so one call yields */
+/* N samples for roughly the cost of a single scalar draw:                    */
+/*                                                                            */
+/*     scl::random_engine<8> rng(seed, thread_index);                         */
+/*     simd<float, 8> u = rng.uniform();          // [0, 1)                   */
+/*     simd<float, 8> g = rng.normal();           // mean 0, deviation 1      */
+/*                                                                            */
+/* Every lane is seeded from the seed and its global lane number, stream * N  */
+/* + lane, through SplitMix64, so the output does not depend on how work is   */
+/* scheduled: lane i of random_engine<N>(s, k) produces the same sequence as  */
+/* lane k * N + i of any other engine with seed s. Giving each thread its own */
+/* stream number is enough for reproducible multithreaded runs. Streams are   */
+/* distinct generators rather than jumps through one sequence; with a period  */
+/* of 2^256 - 1 an overlap between them is not a practical concern.           */
+/*                                                                            */
+/* xoshiro256+ is fast but not cryptographic, and its lowest bits are weaker  */
+/* than the rest, which is why samples are built from the high bits only.     */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+#include "scl_math.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+namespace detail {
+
+/* SplitMix64: advances state by the golden gamma and returns the mixed */
+/* value. Used only to expand a seed into generator state.             */
+constexpr sf_inline std::uint64_t
+splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} /* namespace detail */
+
+template<std::size_t N>
+class random_engine {
+public:
+
+    using state_type = simd<std::uint64_t, N>;
+
+    /* Lanes per call. */
+    static constexpr std::size_t width = N;
+
+    /* Seeds lane i with global lane number stream * N + i. */
+    constexpr explicit random_engine(std::uint64_t seed, std::uint64_t stream = 0) {
+        std::array<std::array<std::uint64_t, N>, 4> words;
+        for (std::size_t i = 0; i < N; ++i) {
+            /* Hash the lane number before combining it with the seed, so */
+            /* that neighbouring lanes do not share SplitMix64 sequences.  */
+            std::uint64_t lane  = stream * N + i;
+            std::uint64_t state = seed ^ detail::splitmix64(lane);
+            for (std::size_t w = 0; w < 4; ++w) {
+                 words[w][i] = detail::splitmix64(state);
+            }
+        }
+        for (std::size_t w = 0; w < 4; ++w) {
+             s[w] = state_type(words[w]);
+        }
+    }
+
+    /* Next 64 random bits in every lane. */
+    constexpr state_type
+    next() {
+        const state_type result = s[0] + s[3];
+        const state_type t      = s[1] << std::uint64_t(17);
+
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3]  = rotl(s[3], 45);
+
+        return result;
+    }
+
+    /* Uniform samples in [0, 1), with 23 random bits for float and 52 for */
+    /* double. The top bits of each draw become the mantissa of a number  */
+    /* in [1, 2), and 1 is subtracted, so no integer conversion is needed. */
+    template<typename T = float>
+    constexpr simd<T, N>
+    uniform() {
+        static_assert(std::is_floating_point<T>::value,
+                      "random_engine::uniform requires a floating-point type");
+        return unit<T>(next());
+    }
+
+    /* Uniform samples in [lo, hi). */
+    template<typename T = float>
+    constexpr simd<T, N>
+    uniform(T lo, T hi) {
+        return fma(uniform<T>(), simd<T, N>(hi - lo), simd<T, N>(lo));
+    }
+
+    /* Standard normal samples by the Box-Muller transform. Only the cosine */
+    /* half of each pair is returned, so a call costs one log, one sqrt and */
+    /* one cos per lane. For float both uniforms come from a single draw,   */
+    /* taken from bits 41-63 and 9-31 respectively.                         */
+    template<typename T = float>
+    constexpr simd<T, N>
+    normal() {
+        static_assert(std::is_floating_point<T>::value,
+                      "random_engine::normal requires a floating-point type");
+        simd<T, N> u1;
+        simd<T, N> u2;
+        if constexpr (std::is_same<T, float>::value) {
+            const state_type bits = next();
+            u1 = unit<float>(bits);
+            u2 = unit<float>(bits << std::uint64_t(32));
+        } else {
+            u1 = unit<T>(next());
+            u2 = unit<T>(next());
+        }
+
+        /* 1 - u1 lies in (0, 1], keeping log finite. */
+        const simd<T, N> r     = math::sqrt(T(-2) * math::log(T(1) - u1));
+        const simd<T, N> theta = u2 * T(6.283185307179586477);
+        return r * math::cos(theta);
+    }
+
+    /* Normal samples with the given mean and standard deviation. */
+    template<typename T = float>
+    constexpr simd<T, N>
+    normal(T mean, T deviation) {
+        return fma(normal<T>(), simd<T, N>(deviation), simd<T, N>(mean));
+    }
+
+    /* The four state vectors, lane i of each belonging to generator i. */
+    constexpr const std::array<state_type, 4>&
+    state() const {
+        return s;
+    }
+
+private:
+
+    /* Maps the high bits of x to [0, 1) as described for uniform(). */
+    template<typename T>
+    static constexpr simd<T, N>
+    unit(const state_type& x) {
+        if constexpr (std::is_same<T, float>::value) {
+            const simd<std::uint32_t, N> mantissa =
+                convert<std::uint32_t>(x >> std::uint64_t(41));
+            return bit_cast<float>(mantissa | std::uint32_t(0x3F800000u)) - 1.0f;
+        } else {
+            const state_type mantissa = x >> std::uint64_t(12);
+            return bit_cast<double>(mantissa | std::uint64_t(0x3FF0000000000000ull)) - 1.0;
+        }
+    }
+
+    std::array<state_type, 4> s;
+
+};
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
@@ -0,0 +1,476 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Structure-of-Arrays Container                         */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* soa_vector<Fields...> stores entity i as one element in each of several    */
+/* independent arrays, one per field, instead of as one struct. Each array is */
+/* aligned and padded to a whole number of N-lane blocks, so a block of any   */
+/* field is a single aligned simd load with no gathers and no bounds checks:  */
+/*                                                                            */
+/*     soa_vector<float, float, float> particles;   // x, v, m                */
+/*     for (auto block : particles) {                                         */
+/*         auto x = block.load<0>();                                          */
+/*         auto v = block.load<1>();                                          */
+/*         block.store<0>(x + v * dt);                                        */
+/*     }                                                                      */
+/*                                                                            */
+/* The last block may be partial. Its padding lanes hold zero after resize    */
+/* and push_back, but a full-width store writes them as well, so reductions   */
+/* over the final block should select with mask<T>() first.                   */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+/* SCL Includes */
+#include "scl.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+/* Default block width: one native register of the widest field, so that */
+/* narrower fields take part of a register rather than several each.    */
+template<typename... Fields>
+inline constexpr std::size_t soa_default_width =
+std::min({ native_width<Fields>... });
+
+template<std::size_t N, typename... Fields>
+class basic_soa_vector {
+public:
+
+    static_assert(sizeof...(Fields) > 0,
+                  "basic_soa_vector requires at least one field");
+
+    static_assert(N > 0,
+                  "basic_soa_vector block width N must be greater than zero");
+
+    /* Lanes per block. */
+    static constexpr std::size_t width = N;
+
+    template<std::size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template<std::size_t I>
+    using block_type = simd<field_type<I>, N>;
+
+    template<typename T>
+    using storage_type = std::vector<T, aligned_allocator<T, 64>>;
+
+public:
+
+    /*---------------------------------------------*/
+    /* Block Proxy and Iterator over Entity Blocks */
+    /*---------------------------------------------*/
+
+    /* One N-entity block, viewed across every field. */
+    template<bool Const>
+    class basic_block {
+    public:
+
+        using owner_type =
+        typename std::conditional<Const, const basic_soa_vector,
+                                          basic_soa_vector>::type;
+
+        constexpr basic_block(owner_type* container, std::size_t index)
+        : owner(container), block_index(index) {}
+
+        /* Index of this block; entity offset() is index() * N. */
+        std::size_t
+        index() const {
+            return block_index;
+        }
+
+        /* Index of the first entity in this block. */
+        std::size_t
+        offset() const {
+            return block_index * N;
+        }
+
+        /* Number of live entities in this block, N except in the last. */
+        std::size_t
+        active() const {
+            return std::min(N, owner->size() - offset());
+        }
+
+        /* Returns true if every lane holds a live entity. */
+        bool
+        full() const {
+            return active() == N;
+        }
+
+        /* Mask of the live lanes, for selecting over the final block. */
+        template<typename T = field_type<0>>
+        typename simd<T, N>::mask_type
+        mask() const {
+            return first_n<T, N>(active());
+        }
+
+        template<std::size_t I>
+        block_type<I>
+        load() const {
+            return owner->template load_block<I>(block_index);
+        }
+
+        template<std::size_t I>
+        void
+        store(const block_type<I>& value) const requires (!Const) {
+            owner->template store_block<I>(block_index, value);
+        }
+
+    private:
+
+        owner_type* owner;
+        std::size_t block_index;
+
+    };
+
+    using block       = basic_block<false>;
+    using const_block = basic_block<true>;
+
+    /* Random-access iteration over blocks; dereferencing yields a block. */
+    template<bool Const>
+    class basic_block_iterator {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = basic_block<Const>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = basic_block<Const>;
+
+        using owner_type = typename basic_block<Const>::owner_type;
+
+        constexpr basic_block_iterator() = default;
+
+        constexpr basic_block_iterator(owner_type* container, std::size_t index)
+        : owner(container), block_index(index) {}
+
+        reference
+        operator*() const {
+            return reference(owner, block_index);
+        }
+
+        reference
+        operator[](difference_type n) const {
+            return reference(owner, block_index + n);
+        }
+
+        basic_block_iterator&
+        operator++() {
+            ++block_index;
+            return *this;
+        }
+
+        basic_block_iterator
+        operator++(int) {
+            basic_block_iterator copy = *this;
+            ++block_index;
+            return copy;
+        }
+
+        basic_block_iterator&
+        operator--() {
+            --block_index;
+            return *this;
+        }
+
+        basic_block_iterator
+        operator--(int) {
+            basic_block_iterator copy = *this;
+            --block_index;
+            return copy;
+        }
+
+        basic_block_iterator&
+        operator+=(difference_type n) {
+            block_index += n;
+            return *this;
+        }
+
+        basic_block_iterator&
+        operator-=(difference_type n) {
+            block_index -= n;
+            return *this;
+        }
+
+        friend basic_block_iterator
+        operator+(basic_block_iterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend basic_block_iterator
+        operator+(difference_type n, basic_block_iterator it) {
+            return it += n;
+        }
+
+        friend basic_block_iterator
+        operator-(basic_block_iterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type
+        operator-(const basic_block_iterator& lhs,
+                  const basic_block_iterator& rhs) {
+            return difference_type(lhs.block_index) -
+                   difference_type(rhs.block_index);
+        }
+
+        friend bool
+        operator==(const basic_block_iterator& lhs,
+                   const basic_block_iterator& rhs) {
+            return lhs.block_index == rhs.block_index;
+        }
+
+        friend auto
+        operator<=>(const basic_block_iterator& lhs,
+                    const basic_block_iterator& rhs) {
+            return lhs.block_index <=> rhs.block_index;
+        }
+
+    private:
+
+        owner_type* owner       = nullptr;
+        std::size_t block_index = 0;
+
+    };
+
+    using iterator       = basic_block_iterator<false>;
+    using const_iterator = basic_block_iterator<true>;
+
+public:
+
+    /*---------------------*/
+    /* Size and Allocation */
+    /*---------------------*/
+
+    basic_soa_vector() = default;
+
+    explicit basic_soa_vector(std::size_t n) {
+        resize(n);
+    }
+
+    /* Number of entities. */
+    std::size_t
+    size() const {
+        return count;
+    }
+
+    bool
+    empty() const {
+        return count == 0;
+    }
+
+    /* Number of blocks, including a partial final block. */
+    std::size_t
+    blocks() const {
+        return padded(count) / N;
+    }
+
+    /* Entities that fit before any field reallocates. */
+    std::size_t
+    capacity() const {
+        return std::get<0>(fields).capacity();
+    }
+
+    void
+    reserve(std::size_t n) {
+        std::apply([&](auto&... field) { (field.reserve(padded(n)), ...); },
+                   fields);
+    }
+
+    /* Resizes every field to n entities. New entities are zero, and the */
+    /* padding after the last entity is cleared again.                   */
+    void
+    resize(std::size_t n) {
+        const std::size_t first = std::min(n, count);
+        std::apply([&](auto&... field) {
+            (field.resize(padded(n)), ...);
+            (std::fill(field.begin() + first, field.end(),
+                       typename std::decay_t<decltype(field)>::value_type{}), ...);
+        }, fields);
+        count = n;
+    }
+
+    void
+    clear() {
+        std::apply([](auto&... field) { (field.clear(), ...); }, fields);
+        count = 0;
+    }
+
+    /* Appends one entity, given one value per field. */
+    void
+    push_back(const Fields&... values) {
+        if (count % N == 0) {
+            std::apply([](auto&... field) {
+                (field.resize(field.size() + N), ...);
+            }, fields);
+        }
+        assign(count, std::index_sequence_for<Fields...>{}, values...);
+        ++count;
+    }
+
+    /* Removes the last entity, zeroing its lane of the final block. */
+    void
+    pop_back() {
+        --count;
+        std::apply([&](auto&... field) {
+            ((field[count] = typename std::decay_t<decltype(field)>::value_type{}), ...);
+            (field.resize(padded(count)), ...);
+        }, fields);
+    }
+
+    /*----------------*/
+    /* Element Access */
+    /*----------------*/
+
+    /* Field I of entity index. */
+    template<std::size_t I>
+    field_type<I>&
+    get(std::size_t index) {
+        return std::get<I>(fields)[index];
+    }
+
+    template<std::size_t I>
+    const field_type<I>&
+    get(std::size_t index) const {
+        return std::get<I>(fields)[index];
+    }
+
+    /* Contiguous storage of field I, aligned to 64 bytes and padded to */
+    /* blocks() * N elements.                                            */
+    template<std::size_t I>
+    field_type<I>*
+    data() {
+        return std::get<I>(fields).data();
+    }
+
+    template<std::size_t I>
+    const field_type<I>*
+    data() const {
+        return std::get<I>(fields).data();
+    }
+
+    /*--------------*/
+    /* Block Access */
+    /*--------------*/
+
+    /* Load block b of field I, entities [b * N, b * N + N). */
+    template<std::size_t I>
+    block_type<I>
+    load_block(std::size_t b) const {
+        block_type<I> result;
+        if constexpr (aligned_blocks<I>) {
+            result.load_aligned(block_pointer<I>(b));
+        } else {
+            result.load(block_pointer<I>(b));
+        }
+        return result;
+    }
+
+    /* Store every lane of block b of field I, padding lanes included. */
+    template<std::size_t I>
+    void
+    store_block(std::size_t b, const block_type<I>& value) {
+        if constexpr (aligned_blocks<I>) {
+            value.store_aligned(block_pointer<I>(b));
+        } else {
+            value.store(block_pointer<I>(b));
+        }
+    }
+
+    /* Mask of the live lanes of block b. */
+    template<typename T = field_type<0>>
+    typename simd<T, N>::mask_type
+    tail_mask(std::size_t b) const {
+        return first_n<T, N>(std::min(N, count - b * N));
+    }
+
+    iterator
+    begin() {
+        return iterator(this, 0);
+    }
+
+    iterator
+    end() {
+        return iterator(this, blocks());
+    }
+
+    const_iterator
+    begin() const {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator
+    end() const {
+        return const_iterator(this, blocks());
+    }
+
+    const_iterator
+    cbegin() const {
+        return begin();
+    }
+
+    const_iterator
+    cend() const {
+        return end();
+    }
+
+private:
+
+    static constexpr std::size_t
+    padded(std::size_t n) {
+        return (n + N - 1) / N * N;
+    }
+
+    /* Blocks start a multiple of N elements from a 64-byte aligned base, */
+    /* so they meet simd::alignment whenever the block size is a multiple */
+    /* of it; the aligned load and store forms are used only then.        */
+    template<std::size_t I>
+    static constexpr bool aligned_blocks =
+    block_type<I>::alignment <= 64 &&
+    (sizeof(field_type<I>) * N) % block_type<I>::alignment == 0;
+
+    template<std::size_t I>
+    field_type<I>*
+    block_pointer(std::size_t b) {
+        return std::get<I>(fields).data() + b * N;
+    }
+
+    template<std::size_t I>
+    const field_type<I>*
+    block_pointer(std::size_t b) const {
+        return std::get<I>(fields).data() + b * N;
+    }
+
+    template<std::size_t... I>
+    void
+    assign(std::size_t index, std::index_sequence<I...>, const Fields&... values) {
+        ((std::get<I>(fields)[index] = values), ...);
+    }
+
+    std::tuple<storage_type<Fields>...> fields;
+    std::size_t                         count = 0;
+
+};
+
+/* Structure-of-arrays container with the default block width. */
+template<typename... Fields>
+using soa_vector = basic_soa_vector<soa_default_width<Fields...>, Fields...>;
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
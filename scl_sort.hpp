@@ -0,0 +1,421 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Sorting Networks and Vectorized Sort                  */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* sort(v) orders the lanes of one simd<T, N> with a bitonic network: log2(N) */
+/* merge stages, each a few layers of permute, min, max and a constant blend, */
+/* with no branches and no memory traffic. merge_sorted(lo, hi) takes two     */
+/* sorted vectors and leaves the N smallest lanes in lo and the N largest in  */
+/* hi, both sorted, which is the step that builds larger sorts.               */
+/*                                                                            */
+/* scl::sort(span) is a quicksort over those pieces:                          */
+/*                                                                            */
+/*     scl::sort(std::span(depths));                                          */
+/*                                                                            */
+/* Ranges are partitioned in place N elements at a time. Each block is split  */
+/* into the keys below the pivot and the rest, packed to opposite ends of two */
+/* vectors, and both are written with full-width stores into slack kept free  */
+/* at either end of the range, so no key is ever moved on its own.            */
+/* Ranges of at most 2N elements are finished with the networks. The pivot is */
+/* the median of an N-element sample, a run of equal keys is split off in one */
+/* extra pass, and a range that still recurses too deeply is handed to        */
+/* std::sort, so the worst case stays O(n log n).                             */
+/*                                                                            */
+/* The partition only pays off with a permute by variable indices: 64-byte    */
+/* blocks of any key under AVX-512, and 32- and 64-bit keys under AVX2. Other */
+/* targets and key sizes call std::sort directly.                             */
+/*                                                                            */
+/* The sort is not stable, and as with std::sort floating-point keys must not */
+/* be NaN. -0.0 and +0.0 compare equal and may come out in either order.      */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+#include "scl_algorithm.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+/*------------------*/
+/* Sorting Networks */
+/*------------------*/
+
+namespace detail {
+
+/* One compare-exchange layer of a bitonic network. Lane i meets lane i ^ J */
+/* and keeps the smaller value if it is the lower lane of its pair within   */
+/* an ascending block, that is a block of K lanes with an even index.       */
+template<std::size_t K, std::size_t J, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+bitonic_layer(const simd<T, N>& v) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        const simd<T, N> partner = permute<(I ^ J)...>(v);
+        const simd<T, N> lo      = min(v, partner);
+        const simd<T, N> hi      = max(v, partner);
+        return shuffle<((((I & J) == 0) == ((I & K) == 0)) ? I : N + I)...>(lo, hi);
+    }(std::make_index_sequence<N>{});
+}
+
+/* Layers J, J/2, ..., 1 of the merge stage for K-lane blocks. */
+template<std::size_t K, std::size_t J, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+bitonic_merge(const simd<T, N>& v) {
+    if constexpr (J == 0) {
+        return v;
+    } else {
+        return bitonic_merge<K, J / 2>(bitonic_layer<K, J>(v));
+    }
+}
+
+/* Merge stages for blocks of K, 2K, ..., N lanes. */
+template<std::size_t K, typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+bitonic_sort(const simd<T, N>& v) {
+    if constexpr (K > N) {
+        return v;
+    } else {
+        return bitonic_sort<2 * K>(bitonic_merge<K, K / 2>(v));
+    }
+}
+
+} /* namespace detail */
+
+/* Returns the lanes of v in ascending order. N must be a power of two. */
+template<typename T, std::size_t N>
+constexpr sf_inline simd<T, N>
+sort(const simd<T, N>& v) {
+    static_assert(std::has_single_bit(N), "sort requires a power-of-two width");
+    return detail::bitonic_sort<2>(v);
+}
+
+/* Given sorted lo and hi, leaves the N smallest of their 2N lanes in lo */
+/* and the N largest in hi, each in ascending order. Reversing hi makes  */
+/* lo:hi bitonic, one min/max layer splits it into halves, and one merge */
+/* stage sorts each half.                                                */
+template<typename T, std::size_t N>
+constexpr sf_inline void
+merge_sorted(simd<T, N>& lo, simd<T, N>& hi) {
+    static_assert(std::has_single_bit(N), "merge_sorted requires a power-of-two width");
+    const simd<T, N> reversed = hi.reverse();
+    const simd<T, N> low      = min(lo, reversed);
+    const simd<T, N> high     = max(lo, reversed);
+    lo = detail::bitonic_merge<2 * N, N / 2>(low);
+    hi = detail::bitonic_merge<2 * N, N / 2>(high);
+}
+
+/*---------------------*/
+/* Sorting over a Span */
+/*---------------------*/
+
+namespace detail {
+
+/* Padding for partial network sorts, ordered after every other key.  */
+/* std::numeric_limits is not specialized for _Float16 or __bf16 before */
+/* C++23, so their infinity comes from float's.                         */
+template<typename T>
+inline constexpr T sort_padding = is_half_float<T>
+                                ? T(std::numeric_limits<float>::infinity())
+                                : std::numeric_limits<T>::has_infinity
+                                ? std::numeric_limits<T>::infinity()
+                                : std::numeric_limits<T>::max();
+
+/* Sorts n <= 2N elements with two registers and merge_sorted. */
+template<typename T, std::size_t N>
+sf_inline void
+sort_small(T* ptr, std::size_t n) {
+    std::array<T, 2 * N> buffer;
+    buffer.fill(sort_padding<T>);
+    std::copy_n(ptr, n, buffer.data());
+    simd<T, N> lo;
+    simd<T, N> hi;
+    lo.load(buffer.data());
+    hi.load(buffer.data() + N);
+    lo = scl::sort(lo);
+    hi = scl::sort(hi);
+    merge_sorted(lo, hi);
+    lo.store(buffer.data());
+    hi.store(buffer.data() + N);
+    std::copy_n(buffer.data(), n, ptr);
+}
+
+/* Median of N keys spread evenly over the range. */
+template<typename T, std::size_t N>
+sf_inline T
+sort_pivot(const T* ptr, std::size_t n) {
+    std::array<T, N> sample;
+    for (std::size_t i = 0; i < N; ++i) {
+         sample[i] = ptr[i * (n - 1) / (N - 1 > 0 ? N - 1 : 1)];
+    }
+    return scl::sort(simd<T, N>(sample)).data[N / 2];
+}
+
+/* True where the vector partition beats std::sort: 64-byte blocks under  */
+/* AVX-512, and the AVX2 kernel below. With narrower registers or no      */
+/* permute by variable indices, compress is a loop and std::sort is used. */
+template<typename T, std::size_t N>
+inline constexpr bool vector_partition =
+#if defined(SF_ISA_AVX512F)
+    sizeof(T) * N == 64 ||
+#endif
+#if defined(SF_ISA_AVX2)
+    (sizeof(T) * N == 32 && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+#endif
+    false;
+
+#if defined(SF_ISA_AVX2)
+
+/* vpermd indices, four bits per 32-bit lane, indexed by the mask bits of */
+/* a block of Lanes keys. Head moves the set lanes to the front and tail  */
+/* moves the clear lanes to the back, both in order; 64-bit keys move as  */
+/* two 32-bit halves.                                                     */
+template<std::size_t Lanes, bool Tail>
+inline constexpr auto partition_indices = [] {
+    constexpr std::uint32_t scale = 8 / Lanes;
+    std::array<std::uint32_t, 1u << Lanes> table {};
+    for (std::uint32_t bits = 0; bits < table.size(); ++bits) {
+        std::uint32_t entry = 0;
+        std::uint32_t k     = Tail ? Lanes : 0;
+        for (std::uint32_t j = 0; j < Lanes; ++j) {
+            const std::uint32_t i = Tail ? Lanes - 1 - j : j;
+            if ((((bits >> i) & 1) != 0) != Tail) {
+                const std::uint32_t slot = Tail ? --k : k++;
+                for (std::uint32_t h = 0; h < scale; ++h) {
+                     entry |= (i * scale + h) << (4 * (slot * scale + h));
+                }
+            }
+        }
+        table[bits] = entry;
+    }
+    return table;
+}();
+
+/* Mask bits of the keys of v that belong left of pivot. Unsigned keys */
+/* are compared as signed after flipping their top bits, and "at most" */
+/* is the complement of "greater than".                                */
+template<bool Inclusive, typename T>
+sf_inline std::uint32_t
+partition_bits(__m256i v, __m256i pivot) {
+    if constexpr (std::is_same<T, float>::value) {
+        return std::uint32_t(_mm256_movemask_ps(
+               _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_castsi256_ps(pivot),
+                             Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ)));
+    } else if constexpr (std::is_same<T, double>::value) {
+        return std::uint32_t(_mm256_movemask_pd(
+               _mm256_cmp_pd(_mm256_castsi256_pd(v), _mm256_castsi256_pd(pivot),
+                             Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ)));
+    } else {
+        constexpr std::uint32_t all = sizeof(T) == 4 ? 0xFFu : 0xFu;
+        if constexpr (std::is_unsigned<T>::value) {
+            const __m256i flip = sizeof(T) == 4
+                               ? _mm256_set1_epi32(std::int32_t(0x80000000u))
+                               : _mm256_set1_epi64x(std::int64_t(0x8000000000000000ull));
+            v     = _mm256_xor_si256(v, flip);
+            pivot = _mm256_xor_si256(pivot, flip);
+        }
+        const __m256i  greater  = Inclusive
+                                ? (sizeof(T) == 4 ? _mm256_cmpgt_epi32(v, pivot)
+                                                  : _mm256_cmpgt_epi64(v, pivot))
+                                : (sizeof(T) == 4 ? _mm256_cmpgt_epi32(pivot, v)
+                                                  : _mm256_cmpgt_epi64(pivot, v));
+        const std::uint32_t bits = sizeof(T) == 4
+                                 ? std::uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(greater)))
+                                 : std::uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(greater)));
+        return Inclusive ? bits ^ all : bits;
+    }
+}
+
+#endif
+
+/* Splits the N keys at block around the pivot: those that belong left of */
+/* it are packed at the front of a vector stored to left, and the rest at */
+/* the back of one stored to right - N. Both stores are full width, so    */
+/* N slots must be free at each end. Inclusive puts keys equal to the     */
+/* pivot left. Returns the number of keys that went left.                 */
+template<bool Inclusive, typename T, std::size_t N>
+sf_inline std::size_t
+partition_block(T* left, T* right, const T* block, T pivot) {
+    #if defined(SF_ISA_AVX2)
+    if constexpr (sizeof(T) * N == 32 && (sizeof(T) == 4 || sizeof(T) == 8)) {
+        const __m256i       v      = _mm256_loadu_si256(
+                                     reinterpret_cast<const __m256i*>(block));
+        const __m256i       p      = std::bit_cast<__m256i>(simd<T, N>(pivot).data);
+        const __m256i       shift  = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+        const __m256i       nibble = _mm256_set1_epi32(0xF);
+        const std::uint32_t bits   = partition_bits<Inclusive, T>(v, p);
+        const __m256i       head   = _mm256_and_si256(_mm256_srlv_epi32(
+                                     _mm256_set1_epi32(std::int32_t(
+                                     partition_indices<N, false>[bits])), shift), nibble);
+        const __m256i       tail   = _mm256_and_si256(_mm256_srlv_epi32(
+                                     _mm256_set1_epi32(std::int32_t(
+                                     partition_indices<N, true>[bits])), shift), nibble);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(left),
+                            _mm256_permutevar8x32_epi32(v, head));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(right - N),
+                            _mm256_permutevar8x32_epi32(v, tail));
+        return std::size_t(std::popcount(bits));
+    }
+    #endif
+    simd<T, N> v;
+    v.load(block);
+    const simd<T, N> reversed = v.reverse();
+    typename simd<T, N>::mask_type below;
+    typename simd<T, N>::mask_type above;
+    if constexpr (Inclusive) {
+        below = v <= pivot;
+        above = reversed > pivot;
+    } else {
+        below = v < pivot;
+        above = reversed >= pivot;
+    }
+    compress(v, below).store(left);
+    compress(reversed, above).reverse().store(right - N);
+    return popcount<T, N>(below);
+}
+
+/* The same split, storing exactly the lanes that are kept. Used where the */
+/* slack at either end has run out.                                        */
+template<bool Inclusive, typename T, std::size_t N>
+sf_inline std::size_t
+partition_block_exact(T* left, T* right, const simd<T, N>& v, T pivot) {
+    const auto below = Inclusive ? (v <= pivot) : (v < pivot);
+    const std::size_t count = compress_store(left, v, below);
+    compress_store(right - (N - count), v, ~below);
+    return count;
+}
+
+/* Partitions n > 2N elements around pivot and returns the size of the left */
+/* part. The first and last blocks are held in registers, which leaves N    */
+/* free slots at each end. Every step reads the next block from whichever   */
+/* end has less slack, so both ends have at least N free slots when its two */
+/* full-width stores are made.                                              */
+template<bool Inclusive, typename T, std::size_t N>
+sf_inline std::size_t
+partition(T* ptr, std::size_t n, T pivot) {
+    simd<T, N> first;
+    simd<T, N> last;
+    first.load(ptr);
+    last.load(ptr + n - N);
+
+    std::size_t read_left   = N;
+    std::size_t read_right  = n - N;
+    std::size_t write_left  = 0;
+    std::size_t write_right = n;
+
+    while (read_right - read_left >= N) {
+        const T* block;
+        if (read_left - write_left <= write_right - read_right) {
+            block      = ptr + read_left;
+            read_left += N;
+        } else {
+            read_right -= N;
+            block       = ptr + read_right;
+        }
+        const std::size_t count = partition_block<Inclusive, T, N>(
+                                  ptr + write_left, ptr + write_right, block, pivot);
+        write_left  += count;
+        write_right -= N - count;
+    }
+
+    /* Fewer than N unread keys remain between the two read positions. Once */
+    /* they are copied out, [write_left, write_right) is all free and holds */
+    /* exactly the keys still to be placed.                                 */
+    std::array<T, N> rest;
+    const std::size_t remaining = read_right - read_left;
+    std::copy_n(ptr + read_left, remaining, rest.data());
+
+    for (const simd<T, N>& v : { first, last }) {
+        const std::size_t count = partition_block_exact<Inclusive>(
+                                  ptr + write_left, ptr + write_right, v, pivot);
+        write_left  += count;
+        write_right -= N - count;
+    }
+    for (std::size_t i = 0; i < remaining; ++i) {
+        const T key = rest[i];
+        if (Inclusive ? !(pivot < key) : key < pivot) {
+            ptr[write_left++] = key;
+        } else {
+            ptr[--write_right] = key;
+        }
+    }
+    return write_left;
+}
+
+template<typename T, std::size_t N>
+void
+sort_range(T* ptr, std::size_t n, std::size_t depth) {
+    while (n > 2 * N) {
+        if (depth == 0) {
+            std::sort(ptr, ptr + n);
+            return;
+        }
+        --depth;
+
+        const T pivot = sort_pivot<T, N>(ptr, n);
+        std::size_t split = partition<false, T, N>(ptr, n, pivot);
+        if (split == 0) {
+            /* Nothing is below the pivot, so it is the minimum: take every */
+            /* key equal to it off the front, where they are already done.  */
+            split = partition<true, T, N>(ptr, n, pivot);
+            ptr += split;
+            n   -= split;
+            continue;
+        }
+
+        /* Recurse into the smaller part and loop on the larger, so the */
+        /* stack grows by at most log2(n) frames.                       */
+        if (split < n - split) {
+            sort_range<T, N>(ptr, split, depth);
+            ptr += split;
+            n   -= split;
+        } else {
+            sort_range<T, N>(ptr + split, n - split, depth);
+            n = split;
+        }
+    }
+    sort_small<T, N>(ptr, n);
+}
+
+} /* namespace detail */
+
+/* Sorts the keys of in into ascending order. N, the block width,    */
+/* defaults to native_width<T> and must be a power of two; ranges of */
+/* at most 2N keys are sorted entirely in registers.                 */
+template<std::size_t N = 0, typename T, std::size_t E>
+void
+sort(std::span<T, E> in) {
+    static_assert((std::is_arithmetic<T>::value || detail::is_half_float<T>) &&
+                  !std::is_const<T>::value,
+                  "sort requires a span of mutable arithmetic keys");
+    constexpr std::size_t W = detail::algorithm_width<N, T>;
+    static_assert(std::has_single_bit(W), "sort requires a power-of-two width");
+    const std::size_t n = in.size();
+    if constexpr (!detail::vector_partition<T, W>) {
+        std::sort(in.begin(), in.end());
+    } else if (n > 1) {
+        detail::sort_range<T, W>(in.data(), n, 2 * std::bit_width(n));
+    }
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
@@ -0,0 +1,347 @@
+#pragma once
+
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* SIMD Class Library - Byte Scanning                                         */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Searching, classifying and validating byte strings a register at a time,   */
+/* in the style of memchr and simdjson. Everything is built on simd<uint8_t,  */
+/* N> comparisons, to_bitfield and 16-entry lookup, so it compiles to         */
+/* pcmpeqb/pmovmskb/pshufb on x86 and cmeq/tbl on AArch64 without any code    */
+/* specific to either:                                                        */
+/*                                                                            */
+/*     auto nl   = scl::find_byte(std::span(text), '\n');                     */
+/*     auto stop = scl::find_any_of(std::span(text), scl::byte_set("\",\\")); */
+/*     bool ok   = scl::validate_utf8(std::span(text));                       */
+/*                                                                            */
+/* Span functions accept spans of any one-byte type, char and std::byte       */
+/* included, and N defaults to native_width<std::uint8_t>. byte_set tests     */
+/* membership with one pair of nibble lookups for most sets, and two pairs    */
+/* when the set needs more than eight distinct high-nibble classes.           */
+/*                                                                            */
+/* The 16-entry lookup is one pshufb only with SSSE3 or later; SSE2-only      */
+/* builds use the scalar fallback for byte_set and validate_utf8, while       */
+/* find_byte and count_byte need nothing beyond SSE2.                         */
+/*                                                                            */
+/*============================================================================*/
+/*============================================================================*/
+/*============================================================================*/
+
+/* Standard Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+/* SCL Includes */
+#include "scl.hpp"
+#include "scl_algorithm.hpp"
+
+namespace sf  {
+namespace scl {
+inline namespace SCL_ISA_NAMESPACE {
+
+namespace detail {
+
+/* Element types a byte span may have. */
+template<typename T>
+concept byte_type = sizeof(T) == 1 && (std::is_integral<T>::value ||
+                    std::is_same<std::remove_cv_t<T>, std::byte>::value);
+
+template<typename T, std::size_t E>
+sf_inline std::span<const std::uint8_t>
+as_bytes(std::span<T, E> in) {
+    return { reinterpret_cast<const std::uint8_t*>(in.data()), in.size() };
+}
+
+} /* namespace detail */
+
+/*---------------------*/
+/* Byte Classification */
+/*---------------------*/
+
+/* A set of byte values, tested a register at a time by splitting each byte */
+/* into nibbles: lane i is a member when low[v & 15] & high[v >> 4] != 0.   */
+/* Every bit of the tables stands for a class of high nibbles that pair     */
+/* with the same low nibbles, so any set with at most eight such classes,   */
+/* which covers ASCII punctuation, digits and letters, needs one table pair */
+/* and every other set needs two.                                           */
+class byte_set {
+public:
+
+    constexpr explicit byte_set(std::string_view bytes) {
+        std::array<std::uint16_t, 16> lows = {};
+        for (char c : bytes) {
+             const std::uint8_t b = std::uint8_t(c);
+             lows[b >> 4] |= std::uint16_t(1u << (b & 15));
+        }
+
+        /* High nibbles with identical low-nibble sets share a class. */
+        std::array<std::uint16_t, 16> classes = {};
+        std::size_t                   count   = 0;
+        for (std::size_t h = 0; h < 16; ++h) {
+            if (lows[h] == 0) {
+                continue;
+            }
+            std::size_t k = 0;
+            while (k < count && classes[k] != lows[h]) {
+                ++k;
+            }
+            if (k == count) {
+                classes[count++] = lows[h];
+            }
+            high[k / 8][h] = std::uint8_t(1u << (k % 8));
+        }
+        for (std::size_t k = 0; k < count; ++k) {
+            for (std::size_t l = 0; l < 16; ++l) {
+                if ((classes[k] >> l) & 1) {
+                    low[k / 8][l] |= std::uint8_t(1u << (k % 8));
+                }
+            }
+        }
+        pairs = count > 8 ? 2 : 1;
+    }
+
+    constexpr bool
+    contains(std::uint8_t b) const {
+        for (std::size_t t = 0; t < pairs; ++t) {
+            if (low[t][b & 15] & high[t][b >> 4]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* Lanes of v that are members of the set. */
+    template<std::size_t N>
+    constexpr typename simd<std::uint8_t, N>::mask_type
+    contains(const simd<std::uint8_t, N>& v) const {
+        /* lookup reduces the index modulo 16, so v is its own low nibble. */
+        const simd<std::uint8_t, N> upper = v >> std::uint8_t(4);
+        simd<std::uint8_t, N> hits = lookup(simd<std::uint8_t, 16>(low[0]), v) &
+                                     lookup(simd<std::uint8_t, 16>(high[0]), upper);
+        if (pairs == 2) {
+            hits |= lookup(simd<std::uint8_t, 16>(low[1]), v) &
+                    lookup(simd<std::uint8_t, 16>(high[1]), upper);
+        }
+        return hits != std::uint8_t(0);
+    }
+
+private:
+
+    std::array<std::array<std::uint8_t, 16>, 2> low  = {};
+    std::array<std::array<std::uint8_t, 16>, 2> high = {};
+    std::size_t                                 pairs = 1;
+
+};
+
+/* Bitmap of the lanes of v equal to byte, bit i for lane i, as used to */
+/* find quotes, newlines or separators across a block.                  */
+template<std::size_t N>
+constexpr sf_inline std::uint64_t
+match_bits(const simd<std::uint8_t, N>& v, std::uint8_t byte) {
+    return to_bitfield<std::uint8_t, N>(v == byte);
+}
+
+/* Bitmap of the lanes of v that are members of set. */
+template<std::size_t N>
+constexpr sf_inline std::uint64_t
+match_bits(const simd<std::uint8_t, N>& v, const byte_set& set) {
+    return to_bitfield<std::uint8_t, N>(set.contains(v));
+}
+
+/*-----------------*/
+/* Searching Spans */
+/*-----------------*/
+
+/* Iterator to the first element equal to byte, or in.end(). */
+template<std::size_t N = 0, detail::byte_type T, std::size_t E>
+typename std::span<T, E>::iterator
+find_byte(std::span<T, E> in, std::uint8_t byte) {
+    const std::span<const std::uint8_t> bytes = detail::as_bytes(in);
+    const auto found = scl::find_if<N>(bytes, [byte](const auto& v) {
+        return v == byte;
+    });
+    return in.begin() + (found - bytes.begin());
+}
+
+/* Iterator to the first element that is a member of set, or in.end(). */
+template<std::size_t N = 0, detail::byte_type T, std::size_t E>
+typename std::span<T, E>::iterator
+find_any_of(std::span<T, E> in, const byte_set& set) {
+    const std::span<const std::uint8_t> bytes = detail::as_bytes(in);
+    const auto found = scl::find_if<N>(bytes, [&set](const auto& v) {
+        return set.contains(v);
+    });
+    return in.begin() + (found - bytes.begin());
+}
+
+/* Number of elements equal to byte, e.g. the lines in a buffer. */
+template<std::size_t N = 0, detail::byte_type T, std::size_t E>
+std::size_t
+count_byte(std::span<T, E> in, std::uint8_t byte) {
+    return scl::count_if<N>(detail::as_bytes(in), [byte](const auto& v) {
+        return v == byte;
+    });
+}
+
+/*------------------*/
+/* UTF-8 Validation */
+/*------------------*/
+
+namespace detail {
+
+/* Error classes of the lookup method of Keiser and Lemire, "Validating    */
+/* UTF-8 In Less Than One Instruction Per Byte". Each table maps a nibble  */
+/* of a byte pair to the errors it is compatible with; a pair is invalid   */
+/* when some error survives all three. TOO_LARGE_1000 and OVERLONG_4 never */
+/* occur together and share a bit.                                         */
+inline constexpr std::uint8_t utf8_too_short      = 1 << 0;
+inline constexpr std::uint8_t utf8_too_long       = 1 << 1;
+inline constexpr std::uint8_t utf8_overlong_3     = 1 << 2;
+inline constexpr std::uint8_t utf8_too_large      = 1 << 3;
+inline constexpr std::uint8_t utf8_surrogate      = 1 << 4;
+inline constexpr std::uint8_t utf8_overlong_2     = 1 << 5;
+inline constexpr std::uint8_t utf8_too_large_1000 = 1 << 6;
+inline constexpr std::uint8_t utf8_overlong_4     = 1 << 6;
+inline constexpr std::uint8_t utf8_two_conts      = 1 << 7;
+inline constexpr std::uint8_t utf8_carry          = utf8_too_short | utf8_too_long | utf8_two_conts;
+
+/* Indexed by the high nibble of the first byte of a pair. */
+inline constexpr std::array<std::uint8_t, 16> utf8_byte_1_high = {
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+    utf8_too_short | utf8_overlong_2,
+    utf8_too_short,
+    utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+    utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4
+};
+
+/* Indexed by the low nibble of the first byte. */
+inline constexpr std::array<std::uint8_t, 16> utf8_byte_1_low = {
+    utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+    utf8_carry | utf8_overlong_2,
+    utf8_carry,
+    utf8_carry,
+    utf8_carry | utf8_too_large,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000
+};
+
+/* Indexed by the high nibble of the second byte. */
+inline constexpr std::array<std::uint8_t, 16> utf8_byte_2_high = {
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 |
+    utf8_too_large_1000 | utf8_overlong_4,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate  | utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate  | utf8_too_large,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short
+};
+
+/* True when the N bytes at p and the three before them are all ASCII, */
+/* in which case the block cannot hold an error.                       */
+template<std::size_t N>
+sf_always_inline bool
+utf8_ascii(const std::uint8_t* p) {
+    simd<std::uint8_t, N> input;
+    simd<std::uint8_t, N> prev3;
+    input.load(p);
+    prev3.load(p - 3);
+    return horizontal_not<std::uint8_t, N>((input | prev3) >= std::uint8_t(0x80));
+}
+
+/* Nonzero lanes mark errors among the N bytes at p. The three bytes */
+/* before p are read as context, so the caller must provide them.    */
+template<std::size_t N>
+sf_always_inline simd<std::uint8_t, N>
+utf8_errors(const std::uint8_t* p) {
+    using bytes = simd<std::uint8_t, N>;
+
+    /* Neighbouring bytes come from overlapping loads rather than shifts */
+    /* across registers; the loads hit the same cache lines as input.    */
+    bytes input;
+    bytes prev1;
+    bytes prev2;
+    bytes prev3;
+    input.load(p);
+    prev1.load(p - 1);
+    prev2.load(p - 2);
+    prev3.load(p - 3);
+
+    const bytes special = lookup(simd<std::uint8_t, 16>(utf8_byte_1_high), prev1 >> std::uint8_t(4)) &
+                          lookup(simd<std::uint8_t, 16>(utf8_byte_1_low),  prev1) &
+                          lookup(simd<std::uint8_t, 16>(utf8_byte_2_high), input >> std::uint8_t(4));
+
+    /* Bytes two after a 3- or 4-byte lead, or three after a 4-byte lead, */
+    /* must be continuations; only leads of those lengths reach 0x80.     */
+    const bytes third  = subs(prev2, bytes(std::uint8_t(0xE0 - 0x80)));
+    const bytes fourth = subs(prev3, bytes(std::uint8_t(0xF0 - 0x80)));
+    return ((third | fourth) & std::uint8_t(0x80)) ^ special;
+}
+
+} /* namespace detail */
+
+/* True when in is well-formed UTF-8: no overlong forms, surrogates, */
+/* code points above U+10FFFF, or truncated and stray continuation   */
+/* bytes. Errors are accumulated and tested once at the end, so the  */
+/* cost does not depend on whether or where the input is invalid.    */
+template<std::size_t N = 0, detail::byte_type T, std::size_t E>
+bool
+validate_utf8(std::span<T, E> in) {
+    constexpr std::size_t W = detail::algorithm_width<N, std::uint8_t>;
+    const std::uint8_t* src = detail::as_bytes(in).data();
+    const std::size_t   n   = in.size();
+
+    simd<std::uint8_t, W> error(std::uint8_t(0));
+    const auto check = [&error](const std::uint8_t* p) {
+        if (!detail::utf8_ascii<W>(p)) {
+            error |= detail::utf8_errors<W>(p);
+        }
+    };
+
+    /* The first block and the tail go through a buffer with three bytes */
+    /* of context in front and zeros behind. The zeros are ASCII, so a   */
+    /* sequence cut off by the end of the input fails as TOO_SHORT.      */
+    std::array<std::uint8_t, W + 3> buffer;
+    std::size_t                     i = 0;
+    if (n >= W) {
+        buffer.fill(0);
+        std::memcpy(buffer.data() + 3, src, W);
+        check(buffer.data() + 3);
+        i = W;
+    }
+    for (; i + W <= n; i += W) {
+         check(src + i);
+    }
+    buffer.fill(0);
+    const std::size_t context = i < 3 ? i : 3;
+    if (n != 0) {
+        std::memcpy(buffer.data() + 3 - context, src + i - context, context + (n - i));
+    }
+    check(buffer.data() + 3);
+
+    return horizontal_not<std::uint8_t, W>(error != std::uint8_t(0));
+}
+
+} /* inline namespace SCL_ISA_NAMESPACE */
+} /* namespace scl */
+} /* namespace sf  */
@@ -110,6 +110,33 @@
    #define sf_unreachable()
 #endif
 
+/* Tells the compiler that pointer p is aligned to n bytes */
+#if defined(__clang__) || defined(__GNUC__)
+   #define sf_assume_aligned(p,n)  __builtin_assume_aligned((p), (n))
+#else
+   #define sf_assume_aligned(p,n)  (p)
+#endif
+
+/* Checks whether the compiler provides the builtin x */
+#if defined(__has_builtin)
+   #define sf_has_builtin(x)   __has_builtin(x)
+#else
+   #define sf_has_builtin(x)   0
+#endif
+
+/* Asks the compiler to unroll the next loop up to n times, which lets GCC */
+/* turn small fixed-count inner loops into straight-line shuffles          */
+#if defined(__clang__)
+   #define sf_pragma(x)        _Pragma(#x)
+   #define sf_unroll(n)        sf_pragma(unroll n)
+#elif defined(__GNUC__)
+   #define sf_pragma(x)        _Pragma(#x)
+   #define sf_unroll(n)        sf_pragma(GCC unroll n)
+#else
+   #define sf_pragma(x)
+   #define sf_unroll(n)
+#endif
+
 /* Suppresses unused parameter warnings */
 #define sf_unused_parameter(x)  (void)(x)
 
@@ -120,6 +147,120 @@
    #define sf_offset_of(s,m)   ((size_t)&(((s*)0)->m))
 #endif
 
+/*============================================================================*/
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/* Instruction Set Detection - Vector Extensions Enabled for the Target       */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/* Each macro is defined to 1 when the compiler is targeting the extension.   */
+/* These reflect compile-time flags (-m..., /arch:...) only, not the CPU the  */
+/* program ends up running on.                                                */
+/*                                                                            */
+/*============================================================================*/
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+   #define SF_ISA_SSE2         1
+#endif
+
+#if defined(__AVX__)
+   #define SF_ISA_AVX          1
+#endif
+
+#if defined(__AVX2__)
+   #define SF_ISA_AVX2         1
+#endif
+
+#if defined(__AVX512F__)
+   #define SF_ISA_AVX512F      1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+   #define SF_ISA_NEON         1
+#endif
+
+#if defined(__ARM_FEATURE_SVE)
+   #define SF_ISA_SVE          1
+#endif
+
+#if defined(__wasm_simd128__)
+   #define SF_ISA_WASM_SIMD128 1
+#endif
+
+#if defined(__riscv_vector)
+   #define SF_ISA_RVV          1
+#endif
+
+#if defined(__ALTIVEC__) || defined(__VSX__)
+   #define SF_ISA_ALTIVEC      1
+#endif
+
+/* Fused multiply-add in hardware, for float and double */
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA) || \
+    defined(__riscv_flen) || defined(__VSX__)
+   #define SF_ISA_FMA          1
+#endif
+
+/* Conversion between float and IEEE half precision, 4 to 16 lanes at once */
+#if defined(__F16C__)
+   #define SF_ISA_F16C         1
+#endif
+
+/* Arithmetic on half-precision lanes, AVX512-FP16 or ARMv8.2 FP16 */
+#if defined(__AVX512FP16__) || defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+   #define SF_ISA_FP16         1
+#endif
+
+/* The compiler provides _Float16 and __bf16 as arithmetic types */
+#if defined(__FLT16_MAX__)
+   #define SF_HAS_FLOAT16      1
+#endif
+
+#if defined(__BFLT16_MAX__)
+   #define SF_HAS_BFLOAT16     1
+#endif
+
+/* Width in bytes of the widest vector register the target can use. Length- */
+/* agnostic SVE and RVV report their fixed length when one is set with     */
+/* -msve-vector-bits / -mrvv-vector-bits, and otherwise their 128-bit      */
+/* minimum. Targets without vector extensions also report 16 so that code */
+/* sized from this value still splits evenly when ported to one that has. */
+#if defined(SF_ISA_AVX512F)
+   #define SF_ISA_VECTOR_BYTES 64
+#elif defined(SF_ISA_AVX)
+   #define SF_ISA_VECTOR_BYTES 32
+#elif defined(SF_ISA_SVE) && defined(__ARM_FEATURE_SVE_BITS) && \
+      __ARM_FEATURE_SVE_BITS > 0
+   #define SF_ISA_VECTOR_BYTES (__ARM_FEATURE_SVE_BITS / 8)
+#elif defined(SF_ISA_RVV) && defined(__riscv_v_fixed_vlen)
+   #define SF_ISA_VECTOR_BYTES (__riscv_v_fixed_vlen / 8)
+#else
+   #define SF_ISA_VECTOR_BYTES 16
+#endif
+
+/* Compiles one function for an instruction set beyond the build's baseline */
+/* so it can be selected at run time. The isa string is target-specific,   */
+/* e.g. "avx2,fma" on x86 or "+sve" on AArch64. sf_target_clones instead   */
+/* emits one copy per listed target plus an ifunc resolver that picks the  */
+/* best at load time; it needs ifunc support and falls back to a single    */
+/* baseline copy elsewhere.                                                */
+#if defined(__clang__) || defined(__GNUC__)
+   #define sf_target(isa)      __attribute__((target(isa)))
+#else
+   #define sf_target(isa)
+#endif
+
+#if defined(__has_attribute)
+   #if __has_attribute(target_clones) && defined(__ELF__) && \
+      (defined(__x86_64__) || defined(__i386__))
+      #define sf_target_clones(...) __attribute__((target_clones(__VA_ARGS__)))
+   #endif
+#endif
+#if !defined(sf_target_clones)
+   #define sf_target_clones(...)
+#endif
+
 /*============================================================================*/
 /*                                                                            */
 /*----------------------------------------------------------------------------*/